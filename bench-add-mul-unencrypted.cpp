@@ -1,16 +1,43 @@
 #define PROFILE
 #include <iostream>
 #include <cstdint>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "utils.h"
+#include "simd-kernels.h"
+#include "results.h"
 #include "openfhe.h"
 
 using namespace lbcrypto;
 
-int main()
+// Compares every kernel of one level against the plain loops in utils.cpp and
+// throws on the first mismatch.
+static void checkKernels(const SimdKernels& kernels, const std::vector<double>& a, const std::vector<double>& b)
 {
-  uint32_t numRuns = 1000;
+  std::vector<double> out(a.size());
+  auto check = [&kernels, &out](const char* name, const std::vector<double>& expected) {
+    if (out != expected) {
+      throw std::runtime_error(std::string("Mismatch in the ") + simdLevelName(kernels.level) + " " + name + " kernel");
+    }
+  };
+  kernels.add(a.data(), b.data(), out.data(), a.size());
+  check("add", pointwiseAdd(a, b));
+  kernels.subtract(a.data(), b.data(), out.data(), a.size());
+  check("subtract", pointwiseSubtract(a, b));
+  kernels.multiply(a.data(), b.data(), out.data(), a.size());
+  check("multiply", pointwiseMultiply(a, b));
+  kernels.scale(a.data(), 4.0, out.data(), a.size());
+  check("scale", scalarMultiply(a, 4.0));
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.maxRuns = 1000;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
   std::vector<ProfileData> profiles;
 
   uint32_t batchSize = (1 << 15);
@@ -18,84 +45,32 @@ int main()
   std::vector<double> x1 = generateRandomDoubleVector(batchSize, seed);
   std::vector<double> x2 = generateRandomDoubleVector(batchSize, seed);
 
-  ProfileData evalAddProfile;
-  evalAddProfile.operationName = "Add UnEnc";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cAdd = pointwiseAdd(x1, x2);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalAddProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cAdd = pointwiseAdd(x1, x2);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    evalAddProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalAddProfile);
-  }
-
-  ProfileData evalSubProfile;
-  evalSubProfile.operationName = "Sub UnEnc";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cSub = pointwiseSubtract(x1, x2);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalSubProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cSub = pointwiseSubtract(x1, x2);      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    evalSubProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalSubProfile);
-  }
-
-  ProfileData evalMultScalarProfile;
-  evalMultScalarProfile.operationName = "Mult (scalar)";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cScalar = scalarMultiply(x1, 4.0);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalMultScalarProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cScalar = scalarMultiply(x1, 4.0);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    evalMultScalarProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalMultScalarProfile);
+  profiles.push_back(measureOperation("Add UnEnc", options, [&] { return pointwiseAdd(x1, x2); }));
+  profiles.push_back(measureOperation("Sub UnEnc", options, [&] { return pointwiseSubtract(x1, x2); }));
+  profiles.push_back(measureOperation("Mult (scalar)", options, [&] { return scalarMultiply(x1, 4.0); }));
+  profiles.push_back(measureOperation("Mult UnEnc", options, [&] { return pointwiseMultiply(x1, x2); }));
+
+  // distinct inputs whose length is not a multiple of any vector width, so the remainder loops are checked too
+  std::vector<double> check1 = generateRandomDoubleVector(batchSize + 3, seed + 1);
+  std::vector<double> check2 = generateRandomDoubleVector(batchSize + 3, seed + 2);
+
+  // the same operations without allocation, once per instruction set the CPU supports
+  std::vector<double> out(batchSize);
+  for (SimdLevel level : supportedSimdLevels()) {
+    const SimdKernels& kernels = simdKernels(level);
+    std::string suffix = std::string(" [") + simdLevelName(level) + "]";
+    profiles.push_back(measureOperation("Add" + suffix, options, [&] { kernels.add(x1.data(), x2.data(), out.data(), batchSize); }));
+    profiles.push_back(measureOperation("Sub" + suffix, options, [&] { kernels.subtract(x1.data(), x2.data(), out.data(), batchSize); }));
+    profiles.push_back(measureOperation("Mult (scalar)" + suffix, options, [&] { kernels.scale(x1.data(), 4.0, out.data(), batchSize); }));
+    profiles.push_back(measureOperation("Mult" + suffix, options, [&] { kernels.multiply(x1.data(), x2.data(), out.data(), batchSize); }));
+
+    checkKernels(kernels, check1, check2);
   }
 
-  ProfileData evalMultProfile;
-  evalMultProfile.operationName = "Mult UnEnc";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cMul = pointwiseMultiply(x1, x2);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalMultProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cMul = pointwiseMultiply(x1, x2);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    evalMultProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalMultProfile);
-  }
+  // in place, through the dispatched kernels; add and subtract keep the values bounded over many runs
+  std::vector<double> acc = x1;
+  profiles.push_back(measureOperation("Add in-place", options, [&] { pointwiseAdd(acc, x2, acc); }));
+  profiles.push_back(measureOperation("Sub in-place", options, [&] { pointwiseSubtract(acc, x2, acc); }));
 
   auto cAdd = pointwiseAdd(x1, x2);
   auto cSub = pointwiseSubtract(x1, x2);
@@ -114,7 +89,10 @@ int main()
   printDoubleVector(cScalar, "Scalar", 5);
   printDoubleVector(cMul, "Mul", 5);
 
+  std::cout << "\nSIMD kernels: " << simdLevelName(detectSimdLevel()) << std::endl;
   printProfileResults(profiles);
 
+  writeResults(args, "bench-add-mul-unencrypted", {{{{"batch_size", std::to_string(batchSize)}}, profiles}});
+
   return 0;
 }
\ No newline at end of file
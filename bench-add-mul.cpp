@@ -31,347 +31,650 @@
 
 #define PROFILE
 #include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "thread-pool.h"
 #include "openfhe.h"
 
 using namespace lbcrypto;
 
-int main()
+// Runs the full operation list against a single parameter set.
+// The detailed per-configuration output is only printed when verbose is set.
+static std::vector<ProfileData> runAddMul(const CKKSConfig& config, const ProfileOptions& options, bool verbose)
 {
-  uint32_t numRuns = 100;
   std::vector<ProfileData> profiles;
+  uint32_t batchSize = config.batchSize;
 
-  uint32_t multDepth = 10;
-  uint32_t scaleModSize = 59;
-  uint32_t firstModSize = 60;
-  uint32_t batchSize = (1 << 15);
-
-  CCParams<CryptoContextCKKSRNS> parameters;
-  parameters.SetMultiplicativeDepth(multDepth);
-  parameters.SetFirstModSize(firstModSize);
-  parameters.SetScalingModSize(scaleModSize);
-  parameters.SetBatchSize(batchSize);
-  parameters.SetSecurityLevel(HEStd_NotSet);
-  parameters.SetRingDim(2 * batchSize);
-  // parameters.SetKeySwitchTechnique(HYBRID);
-
-  CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
-  cc->Enable(PKE);
-  cc->Enable(KEYSWITCH);
-  cc->Enable(LEVELEDSHE);
-
-  std::cout << "\n\nNote this build is SINGLE-THREADED \n\n";
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+
+  printThreadingInfo();
   std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl
             << std::endl;
 
-  auto keys = cc->KeyGen();
-  auto print_moduli_chain = [](const DCRTPoly &poly)
-  {
-    int num_primes = poly.GetNumOfElements();
-    double total_bit_len = 0.0;
-    for (int i = 0; i < num_primes; i++)
-    {
-      auto qi = poly.GetParams()->GetParams()[i]->GetModulus();
-      std::cout << "q_" << i << ": "
-                << qi
-                << ",  log q_" << i << ": " << log(qi.ConvertToDouble()) / log(2)
-                << std::endl;
-      total_bit_len += log(qi.ConvertToDouble()) / log(2);
-    }
-    std::cout << "Total bit length: " << total_bit_len << std::endl;
-  };
+  auto keys = generateAddMulKeys(cc);
   const std::vector<DCRTPoly> &ckks_pk = keys.publicKey->GetPublicElements();
   std::cout << "Moduli chain of pk: " << std::endl;
-  print_moduli_chain(ckks_pk[0]);
-
-  cc->EvalMultKeyGen(keys.secretKey);
-  cc->EvalRotateKeyGen(keys.secretKey, {1, -2});
+  printModuliChain(ckks_pk[0]);
 
   uint32_t seed = 42;
-  std::vector<double> x1 = generateRandomDoubleVector(batchSize, seed);
-  std::vector<double> x2 = generateRandomDoubleVector(batchSize, seed);
+  OpInputs inputs = makeOpInputs(cc, keys, batchSize, seed);
 
-  ProfileData makePlaintextProfile;
-  makePlaintextProfile.operationName = "MakeCKKSPackedPlaintext";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    Plaintext ptxt1 = cc->MakeCKKSPackedPlaintext(x1);
-    auto end = std::chrono::high_resolution_clock::now();
-    makePlaintextProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      ptxt1 = cc->MakeCKKSPackedPlaintext(x1);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    makePlaintextProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(makePlaintextProfile);
+  if (verbose) {
+    std::cout << "Input x1: " << inputs.ptxt1 << std::endl;
   }
 
-  Plaintext ptxt1 = cc->MakeCKKSPackedPlaintext(x1);
-  Plaintext ptxt2 = cc->MakeCKKSPackedPlaintext(x2);
+  for (const auto& op : makeAddMulOps(cc, keys)) {
+    profiles.push_back(profileOp(op, inputs, options));
+  }
 
-  std::cout << "Input x1: " << ptxt1 << std::endl;
-  std::cout << "Input x2: " << ptxt2 << std::endl;
+  const auto& c1 = inputs.c1;
+  const auto& c2 = inputs.c2;
+  auto cAdd = cc->EvalAdd(c1, c2);
+  auto cSub = cc->EvalSub(c1, c2);
+  auto cScalar = cc->EvalMult(c1, 4.0);
+  auto cMul = cc->EvalMult(c1, c2);
+  auto cRot1 = cc->EvalRotate(c1, 1);
+  auto cRot2 = cc->EvalRotate(c1, -2);
 
-  ProfileData encryptProfile;
-  encryptProfile.operationName = "Encrypt";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto c1 = cc->Encrypt(keys.publicKey, ptxt1);
-    auto end = std::chrono::high_resolution_clock::now();
-    encryptProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      c1 = cc->Encrypt(keys.publicKey, ptxt1);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    encryptProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(encryptProfile);
+  Plaintext result;
+  std::cout.precision(8);
+  std::cout << std::endl
+            << "Results of homomorphic computations: " << std::endl;
+
+  cc->Decrypt(keys.secretKey, c1, &result);
+  result->SetLength(batchSize);
+  if (verbose) {
+    std::cout << "x1 = " << result;
   }
+  std::cout << "Estimated precision in bits: " << result->GetLogPrecision() << std::endl;
 
-  auto c1 = cc->Encrypt(keys.publicKey, ptxt1);
-  auto c2 = cc->Encrypt(keys.publicKey, ptxt2);
+  cc->Decrypt(keys.secretKey, cAdd, &result);
+  result->SetLength(batchSize);
+  if (verbose) {
+    std::cout << "x1 + x2 = " << result;
+  }
+  std::cout << "Estimated precision in bits: " << result->GetLogPrecision() << std::endl;
 
-  ProfileData evalAddProfile;
-  evalAddProfile.operationName = "EvalAdd";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cAdd = cc->EvalAdd(c1, c2);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalAddProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cAdd = cc->EvalAdd(c1, c2);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    evalAddProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalAddProfile);
+  if (verbose) {
+    cc->Decrypt(keys.secretKey, cSub, &result);
+    result->SetLength(batchSize);
+    std::cout << "x1 - x2 = " << result << std::endl;
+
+    cc->Decrypt(keys.secretKey, cScalar, &result);
+    result->SetLength(batchSize);
+    std::cout << "4 * x1 = " << result << std::endl;
+
+    cc->Decrypt(keys.secretKey, cMul, &result);
+    result->SetLength(batchSize);
+    std::cout << "x1 * x2 = " << result << std::endl;
+
+    cc->Decrypt(keys.secretKey, cRot1, &result);
+    result->SetLength(batchSize);
+    std::cout << std::endl
+              << "In rotations, very small outputs (~10^-10 here) correspond to 0's:" << std::endl;
+    std::cout << "x1 rotate by 1 = " << result << std::endl;
+
+    cc->Decrypt(keys.secretKey, cRot2, &result);
+    result->SetLength(batchSize);
+    std::cout << "x1 rotate by -2 = " << result << std::endl;
   }
 
-  ProfileData evalSubProfile;
-  evalSubProfile.operationName = "EvalSub";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cSub = cc->EvalSub(c1, c2);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalSubProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cSub = cc->EvalSub(c1, c2);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
+  printProfileResults(profiles);
+
+  // keys are stored in static maps; drop them before the next grid point
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  return profiles;
+}
+
+struct ThroughputRow {
+  std::string operationName;
+  uint32_t threads;
+  double opsPerSec;
+  double speedup;
+  double efficiency;
+  size_t steals;
+};
+
+// Inter-op parallel mode: numJobs independent jobs of each operation are spread
+// over a work-stealing pool sharing one CryptoContext, for every thread count.
+// Scaling losses show contention inside OpenFHE (key maps, allocator, memory bandwidth).
+// Each job runs with a single intra-op thread so that N workers do not start N OpenMP teams.
+// Returns one result set per worker count, with the per-job latencies of every operation.
+static std::vector<ResultSet> runThroughput(const CKKSConfig& config, const BenchArgs& args, const ProfileOptions& options)
+{
+  uint32_t numJobs = args.getUInt("jobs", 64);
+  uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<uint32_t> threadCounts = args.getUIntList("threads", defaultThreadCounts(maxThreads));
+  uint32_t maxUsedThreads = *std::max_element(threadCounts.begin(), threadCounts.end());
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl;
+  std::cout << "Throughput mode: " << numJobs << " jobs per operation, up to "
+            << maxUsedThreads << " worker threads (" << maxThreads << " hardware threads), "
+            << "1 intra-op thread per job" << std::endl;
+
+  auto keys = generateAddMulKeys(cc);
+
+  // one independently encrypted input set per worker; jobs cycle through them
+  std::vector<OpInputs> inputs;
+  for (uint32_t i = 0; i < maxUsedThreads; i++) {
+    inputs.push_back(makeOpInputs(cc, keys, config.batchSize, 42 + i));
+  }
+
+  std::vector<BenchOp> ops = makeAddMulOps(cc, keys);
+  if (args.has("ops")) {
+    std::vector<BenchOp> selected;
+    for (const auto& name : args.getList("ops", {})) {
+      auto it = std::find_if(ops.begin(), ops.end(), [&name](const BenchOp& op) { return op.name == name; });
+      if (it == ops.end()) {
+        throw std::invalid_argument("Unknown operation: " + name);
+      }
+      selected.push_back(*it);
     }
-    evalSubProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalSubProfile);
+    ops = selected;
   }
 
-  ProfileData evalMultScalarProfile;
-  evalMultScalarProfile.operationName = "EvalMult (scalar)";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cScalar = cc->EvalMult(c1, 4.0);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalMultScalarProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cScalar = cc->EvalMult(c1, 4.0);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
+  uint32_t intraOpThreads = currentIntraOpThreads();
+  setIntraOpThreads(1);
+  std::vector<ThroughputRow> rows;
+  std::vector<ResultSet> resultSets;
+  for (uint32_t threads : threadCounts) {
+    ParameterList parameters = config.parameters();
+    parameters.push_back({"threads", std::to_string(threads)});
+    parameters.push_back({"jobs", std::to_string(numJobs)});
+    resultSets.push_back({parameters, {}});
+  }
+  for (const auto& op : ops) {
+    double baseline = 0;
+    for (size_t t = 0; t < threadCounts.size(); t++) {
+      uint32_t threads = threadCounts[t];
+      std::vector<double> latencies(numJobs);
+      WorkStealingPool pool(threads);
+      auto start = std::chrono::high_resolution_clock::now();
+      for (uint32_t j = 0; j < numJobs; j++) {
+        const OpInputs& in = inputs[j % inputs.size()];
+        double* latency = &latencies[j];
+        pool.submit([&op, &in, latency] {
+          // the OpenMP thread count is per thread, so every worker sets its own
+          setIntraOpThreads(1);
+          auto jobStart = std::chrono::high_resolution_clock::now();
+          op.run(in);
+          auto jobEnd = std::chrono::high_resolution_clock::now();
+          *latency = std::chrono::duration<double, std::milli>(jobEnd - jobStart).count();
+        });
+      }
+      pool.wait();
+      auto end = std::chrono::high_resolution_clock::now();
+
+      double seconds = std::chrono::duration<double>(end - start).count();
+      double opsPerSec = numJobs / seconds;
+      if (baseline == 0) {
+        baseline = opsPerSec / threads;
+      }
+      double speedup = opsPerSec / baseline;
+      rows.push_back({op.name, threads, opsPerSec, speedup, speedup / threads, pool.stealCount()});
+
+      ProfileData profile;
+      profile.operationName = op.name;
+      profile.firstRunTime = latencies.empty() ? 0 : latencies.front();
+      profile.stats = computeRunStats(latencies, options.outlierThreshold);
+      profile.avgTimeExcludingFirst = profile.stats.mean;
+      profile.opsPerSecond = opsPerSec;
+      resultSets[t].profiles.push_back(profile);
+    }
+  }
+  setIntraOpThreads(intraOpThreads);
+
+  std::cout << "\n============ Throughput Results ============\n";
+  std::cout << std::left << std::setw(25) << "Operation"
+            << std::right << std::setw(10) << "Threads"
+            << std::right << std::setw(15) << "Ops/sec"
+            << std::right << std::setw(12) << "Speedup"
+            << std::right << std::setw(15) << "Efficiency"
+            << std::right << std::setw(10) << "Steals" << std::endl;
+  std::cout << std::string(87, '-') << std::endl;
+  for (const auto& row : rows) {
+    std::cout << std::left << std::setw(25) << row.operationName
+              << std::right << std::setw(10) << row.threads
+              << std::right << std::fixed << std::setprecision(3) << std::setw(15) << row.opsPerSec
+              << std::right << std::fixed << std::setprecision(2) << std::setw(12) << row.speedup
+              << std::right << std::fixed << std::setprecision(2) << std::setw(14) << 100 * row.efficiency << "%"
+              << std::right << std::setw(10) << row.steals << std::endl;
+  }
+  std::cout << std::string(87, '-') << std::endl;
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  return resultSets;
+}
+
+// Deep copies of a ciphertext, one per timed call, for operations that consume or
+// modify their input; copying happens before timing so only the operation is measured.
+class CiphertextPool {
+public:
+  CiphertextPool(const Ciphertext<DCRTPoly>& source, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      m_items.push_back(source->Clone());
     }
-    evalMultScalarProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalMultScalarProfile);
   }
 
-  ProfileData evalMultProfile;
-  evalMultProfile.operationName = "EvalMult (ciphertext)";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cMul = cc->EvalMult(c1, c2);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalMultProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cMul = cc->EvalMult(c1, c2);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
+  Ciphertext<DCRTPoly>& take() {
+    if (m_next >= m_items.size()) {
+      throw std::runtime_error("Ciphertext pool exhausted");
     }
-    evalMultProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalMultProfile);
+    return m_items[m_next++];
   }
 
-  ProfileData evalMultNoRelinProfile;
-  evalMultNoRelinProfile.operationName = "EvalMultNoRelin";
+private:
+  std::vector<Ciphertext<DCRTPoly>> m_items;
+  size_t m_next = 0;
+};
+
+struct InPlacePair {
+  std::string allocating;
+  std::string inPlace;
+};
+
+// Allocating operations next to their in-place and mutable counterparts.
+// Additions and subtractions accumulate into one preallocated ciphertext; every
+// other in-place call gets its own fresh copy from a pool, because it consumes a level
+// or may rescale its inputs. Rescale is measured on a FIXEDMANUAL context, the only
+// scaling technique where it is not a no-op.
+static std::vector<ProfileData> runInPlace(const CKKSConfig& config, const ProfileOptions& options)
+{
+  std::vector<ProfileData> profiles;
+  size_t poolSize = options.warmupRuns + options.maxRuns;
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  auto keys = generateAddMulKeys(cc);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+  const auto& c1 = inputs.c1;
+  const auto& c2 = inputs.c2;
+
+  Ciphertext<DCRTPoly> accumulator = c1->Clone();
+  profiles.push_back(measureOperation("EvalAdd", options, [&] { return cc->EvalAdd(c1, c2); }));
+  profiles.push_back(measureOperation("EvalAddInPlace", options, [&] { cc->EvalAddInPlace(accumulator, c2); }));
   {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cMulNoRelin = cc->EvalMultNoRelin(c1, c2);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalMultNoRelinProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cMulNoRelin = cc->EvalMultNoRelin(c1, c2);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    evalMultNoRelinProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalMultNoRelinProfile);
+    CiphertextPool lhs(c1, poolSize), rhs(c2, poolSize);
+    profiles.push_back(measureOperation("EvalAddMutable", options, [&] { return cc->EvalAddMutable(lhs.take(), rhs.take()); }));
+  }
+  {
+    CiphertextPool lhs(c1, poolSize), rhs(c2, poolSize);
+    profiles.push_back(measureOperation("EvalAddMutableInPlace", options, [&] { cc->EvalAddMutableInPlace(lhs.take(), rhs.take()); }));
   }
 
-  auto cMulNoRelin = cc->EvalMultNoRelin(c1, c2);
+  profiles.push_back(measureOperation("EvalSub", options, [&] { return cc->EvalSub(c1, c2); }));
+  profiles.push_back(measureOperation("EvalSubInPlace", options, [&] { cc->EvalSubInPlace(accumulator, c2); }));
 
-  ProfileData relinearizeProfile;
-  relinearizeProfile.operationName = "Relinearize";
+  profiles.push_back(measureOperation("EvalMult (scalar)", options, [&] { return cc->EvalMult(c1, 4.0); }));
   {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cMulRelined = cc->Relinearize(cMulNoRelin);
-    auto end = std::chrono::high_resolution_clock::now();
-    relinearizeProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cMulRelined = cc->Relinearize(cMulNoRelin);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    relinearizeProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(relinearizeProfile);
+    CiphertextPool pool(c1, poolSize);
+    profiles.push_back(measureOperation("EvalMultInPlace (scalar)", options, [&] { cc->EvalMultInPlace(pool.take(), 4.0); }));
   }
 
-  ProfileData evalRotateProfile1;
-  evalRotateProfile1.operationName = "EvalRotate (1)";
+  profiles.push_back(measureOperation("EvalMult (ciphertext)", options, [&] { return cc->EvalMult(c1, c2); }));
   {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cRot1 = cc->EvalRotate(c1, 1);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalRotateProfile1.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cRot1 = cc->EvalRotate(c1, 1);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
-    }
-    evalRotateProfile1.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalRotateProfile1);
+    CiphertextPool lhs(c1, poolSize), rhs(c2, poolSize);
+    profiles.push_back(measureOperation("EvalMultMutable", options, [&] { return cc->EvalMultMutable(lhs.take(), rhs.take()); }));
+  }
+  {
+    CiphertextPool lhs(c1, poolSize), rhs(c2, poolSize);
+    profiles.push_back(measureOperation("EvalMultMutableInPlace", options, [&] { cc->EvalMultMutableInPlace(lhs.take(), rhs.take()); }));
   }
 
-  ProfileData evalRotateProfile2;
-  evalRotateProfile2.operationName = "EvalRotate (-2)";
+  profiles.push_back(measureOperation("Relinearize", options, [&] { return cc->Relinearize(inputs.cMulNoRelin); }));
   {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto cRot2 = cc->EvalRotate(c1, -2);
-    auto end = std::chrono::high_resolution_clock::now();
-    evalRotateProfile2.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cRot2 = cc->EvalRotate(c1, -2);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
+    CiphertextPool pool(inputs.cMulNoRelin, poolSize);
+    profiles.push_back(measureOperation("RelinearizeInPlace", options, [&] { cc->RelinearizeInPlace(pool.take()); }));
+  }
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  CKKSConfig manualConfig = config;
+  manualConfig.scalingTechnique = FIXEDMANUAL;
+  CryptoContext<DCRTPoly> manualCc = makeCKKSContext(manualConfig);
+  auto manualKeys = manualCc->KeyGen();
+  manualCc->EvalMultKeyGen(manualKeys.secretKey);
+  OpInputs manualInputs = makeOpInputs(manualCc, manualKeys, config.batchSize, 42);
+  Ciphertext<DCRTPoly> product = manualCc->EvalMult(manualInputs.c1, manualInputs.c2);
+  profiles.push_back(measureOperation("Rescale", options, [&] { return manualCc->Rescale(product); }));
+  {
+    CiphertextPool pool(product, poolSize);
+    profiles.push_back(measureOperation("RescaleInPlace", options, [&] { manualCc->RescaleInPlace(pool.take()); }));
+  }
+
+  manualCc->ClearEvalMultKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  printProfileResults(profiles);
+
+  static const std::vector<InPlacePair> pairs = {
+    {"EvalAdd", "EvalAddInPlace"},
+    {"EvalAdd", "EvalAddMutable"},
+    {"EvalAdd", "EvalAddMutableInPlace"},
+    {"EvalSub", "EvalSubInPlace"},
+    {"EvalMult (scalar)", "EvalMultInPlace (scalar)"},
+    {"EvalMult (ciphertext)", "EvalMultMutable"},
+    {"EvalMult (ciphertext)", "EvalMultMutableInPlace"},
+    {"Relinearize", "RelinearizeInPlace"},
+    {"Rescale", "RescaleInPlace"},
+  };
+  auto find = [&profiles](const std::string& name) -> const ProfileData& {
+    return *std::find_if(profiles.begin(), profiles.end(), [&name](const ProfileData& p) { return p.operationName == name; });
+  };
+
+  std::cout << "\n============ In-Place vs Allocating ============\n";
+  std::cout << std::left << std::setw(25) << "Allocating"
+            << std::left << std::setw(27) << "In-place"
+            << std::right << std::setw(12) << "Alloc (ms)"
+            << std::right << std::setw(15) << "In-place (ms)"
+            << std::right << std::setw(10) << "Gain"
+            << std::right << std::setw(14) << "Allocs/call"
+            << std::right << std::setw(14) << "Allocs saved"
+            << std::right << std::setw(12) << "MB saved" << std::endl;
+  std::cout << std::string(129, '-') << std::endl;
+  for (const auto& pair : pairs) {
+    const ProfileData& base = find(pair.allocating);
+    const ProfileData& variant = find(pair.inPlace);
+    std::cout << std::left << std::setw(25) << pair.allocating
+              << std::left << std::setw(27) << pair.inPlace
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << base.stats.median
+              << std::right << std::fixed << std::setprecision(3) << std::setw(15) << variant.stats.median
+              << std::right << std::fixed << std::setprecision(1) << std::setw(9) << 100 * (1 - variant.stats.median / base.stats.median) << "%"
+              << std::right << std::fixed << std::setprecision(1) << std::setw(14) << variant.allocationsPerRun
+              << std::right << std::fixed << std::setprecision(1) << std::setw(14) << base.allocationsPerRun - variant.allocationsPerRun
+              << std::right << std::fixed << std::setprecision(2) << std::setw(12) << (base.bytesAllocatedPerRun - variant.bytesAllocatedPerRun) / double(1 << 20) << std::endl;
+  }
+  std::cout << std::string(129, '-') << std::endl;
+  std::cout << "Latencies are medians; Gain is the latency saved by the in-place variant." << std::endl;
+
+  return profiles;
+}
+
+struct ParetoPoint {
+  CKKSConfig config;
+  size_t towers;
+  double opSetMs;
+  double circuitMs;
+  double precisionBits;
+  double estimatedBits;
+  bool frontier = false;
+  std::vector<ProfileData> profiles;
+};
+
+// Precision/latency mode: profiles the operation list and a fixed-depth test
+// circuit, c <- c * y + x repeated circuitDepth times, on one scaling technique
+// and scaling modulus size. The inputs are scaled to x < 1/4 and y < 1/2, so
+// that x * (1 + y + ... + y^d) < 1/2 for every depth: at the 59-bit scaling
+// modulus the result must stay well below q0 / (2 * scale) = 1.
+static ParetoPoint runParetoPoint(const CKKSConfig& config, uint32_t circuitDepth, const ProfileOptions& options)
+{
+  ParetoPoint point;
+  point.config = config;
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  auto keys = generateAddMulKeys(cc);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+  point.towers = inputs.c1->GetElements()[0].GetNumOfElements();
+
+  point.opSetMs = 0;
+  for (const auto& op : makeAddMulOps(cc, keys)) {
+    point.profiles.push_back(profileOp(op, inputs, options));
+    point.opSetMs += point.profiles.back().stats.median;
+  }
+
+  // the inputs lie in [0.1, 5)
+  std::vector<double> x = scalarMultiply(inputs.x1, 0.05);
+  std::vector<double> y = scalarMultiply(inputs.x2, 0.1);
+  Ciphertext<DCRTPoly> cx = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x));
+  Ciphertext<DCRTPoly> cy = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(y));
+  bool manual = config.scalingTechnique == FIXEDMANUAL;
+  auto circuit = [&] {
+    Ciphertext<DCRTPoly> c = cx;
+    for (uint32_t i = 0; i < circuitDepth; i++) {
+      c = cc->EvalMult(c, cy);
+      if (manual) {
+        c = cc->Rescale(c);
+      }
+      c = cc->EvalAdd(c, cx);
     }
-    evalRotateProfile2.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(evalRotateProfile2);
+    return c;
+  };
+  point.profiles.push_back(measureOperation("Circuit (depth " + std::to_string(circuitDepth) + ")", options, circuit));
+  point.circuitMs = point.profiles.back().stats.median;
+
+  std::vector<double> expected = x;
+  for (uint32_t i = 0; i < circuitDepth; i++) {
+    expected = pointwiseAdd(pointwiseMultiply(expected, y), x);
+  }
+  Plaintext result;
+  cc->Decrypt(keys.secretKey, circuit(), &result);
+  result->SetLength(config.batchSize);
+  std::vector<double> values = result->GetRealPackedValue();
+  double maxError = 0;
+  for (size_t i = 0; i < expected.size() && i < values.size(); i++) {
+    maxError = std::max(maxError, std::fabs(values[i] - expected[i]));
   }
+  point.precisionBits = maxError > 0 ? -std::log2(maxError) : 0;
+  point.estimatedBits = result->GetLogPrecision();
 
-  auto cAdd = cc->EvalAdd(c1, c2);
-  auto cSub = cc->EvalSub(c1, c2);
-  auto cScalar = cc->EvalMult(c1, 4.0);
-  auto cMul = cc->EvalMult(c1, c2);
-  auto cMulRelined = cc->Relinearize(cMulNoRelin);
-  auto cRot1 = cc->EvalRotate(c1, 1);
-  auto cRot2 = cc->EvalRotate(c1, -2);
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return point;
+}
 
-  ProfileData decryptProfile;
-  decryptProfile.operationName = "Decrypt";
-  {
-    auto start = std::chrono::high_resolution_clock::now();
-    Plaintext result;
-    cc->Decrypt(keys.secretKey, c1, &result);
-    auto end = std::chrono::high_resolution_clock::now();
-    decryptProfile.firstRunTime = std::chrono::duration<double, std::milli>(end - start).count();
-
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++)
-    {
-      start = std::chrono::high_resolution_clock::now();
-      cc->Decrypt(keys.secretKey, c1, &result);
-      end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
+// Marks the points no other point beats on both circuit latency and precision.
+static void markParetoFrontier(std::vector<ParetoPoint>& points)
+{
+  for (auto& p : points) {
+    p.frontier = std::none_of(points.begin(), points.end(), [&p](const ParetoPoint& q) {
+      return q.circuitMs <= p.circuitMs && q.precisionBits >= p.precisionBits &&
+             (q.circuitMs < p.circuitMs || q.precisionBits > p.precisionBits);
+    });
+  }
+}
+
+static void printParetoResults(std::vector<ParetoPoint> points, uint32_t circuitDepth)
+{
+  std::sort(points.begin(), points.end(), [](const ParetoPoint& a, const ParetoPoint& b) { return a.circuitMs < b.circuitMs; });
+
+  std::cout << "\n============ Precision vs Latency ============\n";
+  std::cout << std::left << std::setw(18) << "Scaling"
+            << std::right << std::setw(5) << "dq"
+            << std::right << std::setw(8) << "Towers"
+            << std::right << std::setw(14) << "Op set (ms)"
+            << std::right << std::setw(14) << "Circuit (ms)"
+            << std::right << std::setw(8) << "Bits"
+            << std::right << std::setw(12) << "Est. bits"
+            << std::right << std::setw(8) << "Pareto" << std::endl;
+  std::cout << std::string(87, '-') << std::endl;
+  for (const auto& p : points) {
+    std::cout << std::left << std::setw(18) << scalingTechniqueName(p.config.scalingTechnique)
+              << std::right << std::setw(5) << p.config.scaleModSize
+              << std::right << std::setw(8) << p.towers
+              << std::right << std::fixed << std::setprecision(3) << std::setw(14) << p.opSetMs
+              << std::right << std::fixed << std::setprecision(3) << std::setw(14) << p.circuitMs
+              << std::right << std::fixed << std::setprecision(1) << std::setw(8) << p.precisionBits
+              << std::right << std::fixed << std::setprecision(1) << std::setw(12) << p.estimatedBits
+              << std::right << std::setw(8) << (p.frontier ? "*" : "") << std::endl;
+  }
+  std::cout << std::string(87, '-') << std::endl;
+  std::cout << "Op set is the sum of the operation medians; Circuit is c <- c * y + x repeated " << circuitDepth
+            << " times." << std::endl;
+  std::cout << "Bits = -log2(max error) of the circuit against the plaintext result; Est. bits is OpenFHE's GetLogPrecision." << std::endl;
+  std::cout << "Pareto marks the points no other point beats on both circuit latency and Bits." << std::endl;
+}
+
+// Intra-op mode: every operation is profiled once per OpenMP thread count,
+// with the worker threads pinned to cores. Returns one result set per thread count.
+static std::vector<ResultSet> runThreadSweep(const CKKSConfig& config, const BenchArgs& args, const ProfileOptions& options)
+{
+  std::vector<uint32_t> threadCounts = args.getUIntList("threads", defaultThreadCounts(maxIntraOpThreads()));
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  printThreadingInfo();
+  std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl;
+
+  auto keys = generateAddMulKeys(cc);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+  std::vector<BenchOp> ops = makeAddMulOps(cc, keys);
+
+  uint32_t intraOpThreads = currentIntraOpThreads();
+  IntraOpAffinity affinity = saveIntraOpAffinity(*std::max_element(threadCounts.begin(), threadCounts.end()));
+  std::vector<ScalingRow> rows;
+  std::vector<ResultSet> resultSets;
+  std::vector<double> baseline(ops.size(), 0);
+  for (uint32_t threads : threadCounts) {
+    setIntraOpThreads(threads);
+    pinIntraOpThreads(threads);
+    ParameterList parameters = config.parameters();
+    parameters.push_back({"threads", std::to_string(threads)});
+    parameters.push_back({"jobs", "1"});
+    resultSets.push_back({parameters, {}});
+    for (size_t i = 0; i < ops.size(); i++) {
+      ProfileData profile = profileOp(ops[i], inputs, options);
+      resultSets.back().profiles.push_back(profile);
+      double latency = profile.stats.median;
+      if (baseline[i] == 0) {
+        baseline[i] = latency * threads;
+      }
+      double speedup = baseline[i] / latency;
+      rows.push_back({ops[i].name, threads, latency, speedup, speedup / threads});
     }
-    decryptProfile.avgTimeExcludingFirst = sum / (numRuns - 1);
-    profiles.push_back(decryptProfile);
   }
+  // keep OMP_NUM_THREADS (or any earlier setting) and unpinned workers for the next grid point
+  setIntraOpThreads(intraOpThreads);
+  restoreIntraOpAffinity(affinity);
 
-  Plaintext result;
-  std::cout.precision(8);
-  std::cout << std::endl
-            << "Results of homomorphic computations: " << std::endl;
+  printScalingResults(rows);
 
-  cc->Decrypt(keys.secretKey, c1, &result);
-  result->SetLength(batchSize);
-  std::cout << "x1 = " << result;
-  std::cout << "Estimated precision in bits: " << result->GetLogPrecision() << std::endl;
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
 
-  cc->Decrypt(keys.secretKey, cAdd, &result);
-  result->SetLength(batchSize);
-  std::cout << "x1 + x2 = " << result;
-  std::cout << "Estimated precision in bits: " << result->GetLogPrecision() << std::endl;
+  return resultSets;
+}
 
-  cc->Decrypt(keys.secretKey, cSub, &result);
-  result->SetLength(batchSize);
-  std::cout << "x1 - x2 = " << result << std::endl;
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  std::string mode = args.get("mode", "latency");
+  ProfileOptions defaults;
+  if (mode == "inplace") {
+    // every consuming in-place call needs its own preallocated ciphertext
+    defaults.maxRuns = 20;
+  }
+  if (mode == "pareto") {
+    // one context per scaling technique and modulus size
+    defaults.maxRuns = 20;
+    if (!args.has("scale-mod")) {
+      args.values["scale-mod"] = "30,35,40,45,50,55,59";
+    }
+  }
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
 
-  cc->Decrypt(keys.secretKey, cScalar, &result);
-  result->SetLength(batchSize);
-  std::cout << "4 * x1 = " << result << std::endl;
+  std::vector<CKKSConfig> grid = buildConfigGrid(args);
+  bool sweep = grid.size() > 1;
 
-  cc->Decrypt(keys.secretKey, cMul, &result);
-  result->SetLength(batchSize);
-  std::cout << "x1 * x2 = " << result << std::endl;
+  if (mode == "pareto") {
+    std::vector<ScalingTechnique> techniques;
+    for (const auto& name : args.getList("scaling", {"FIXEDMANUAL", "FIXEDAUTO", "FLEXIBLEAUTO", "FLEXIBLEAUTOEXT"})) {
+      techniques.push_back(scalingTechniqueFromName(name));
+    }
 
-  cc->Decrypt(keys.secretKey, cRot1, &result);
-  result->SetLength(batchSize);
-  std::cout << std::endl
-            << "In rotations, very small outputs (~10^-10 here) correspond to 0's:" << std::endl;
-  std::cout << "x1 rotate by 1 = " << result << std::endl;
+    // the frontier is taken per ring dimension and depth, over scaling techniques and moduli
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<ParetoPoint>> groups;
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> circuitDepths;
+    for (CKKSConfig config : grid) {
+      uint32_t circuitDepth = args.getUInt("circuit-depth", config.multDepth);
+      for (ScalingTechnique technique : techniques) {
+        config.scalingTechnique = technique;
+        std::cout << "Running " << config.label() << std::endl;
+        try {
+          auto key = std::make_pair(config.ringDim, config.multDepth);
+          groups[key].push_back(runParetoPoint(config, circuitDepth, options));
+          circuitDepths[key] = circuitDepth;
+        }
+        catch (const std::exception& e) {
+          std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+        }
+      }
+    }
 
-  cc->Decrypt(keys.secretKey, cRot2, &result);
-  result->SetLength(batchSize);
-  std::cout << "x1 rotate by -2 = " << result << std::endl;
+    std::vector<ResultSet> resultSets;
+    for (auto& group : groups) {
+      markParetoFrontier(group.second);
+      std::cout << "\n============ N=2^" << static_cast<uint32_t>(std::log2(group.first.first))
+                << " L=" << group.first.second << " ============\n";
+      printParetoResults(group.second, circuitDepths[group.first]);
+      for (const auto& point : group.second) {
+        ParameterList parameters = point.config.parameters();
+        // precision and the frontier flag are measured, so they stay out of the
+        // parameters that bench-compare matches rows on
+        parameters.push_back({"circuit_depth", std::to_string(circuitDepths[group.first])});
+        resultSets.push_back({parameters, point.profiles});
+      }
+    }
+    writeResults(args, "bench-add-mul", resultSets);
+    return 0;
+  }
 
-  printProfileResults(profiles);
+  std::vector<SweepResult> results;
+  // throughput and threads rows carry their own thread and job counts
+  std::vector<ResultSet> scalingSets;
+  for (const auto& config : grid) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      if (mode == "throughput") {
+        std::vector<ResultSet> sets = runThroughput(config, args, options);
+        scalingSets.insert(scalingSets.end(), sets.begin(), sets.end());
+      }
+      else if (mode == "threads") {
+        std::vector<ResultSet> sets = runThreadSweep(config, args, options);
+        scalingSets.insert(scalingSets.end(), sets.begin(), sets.end());
+      }
+      else if (mode == "inplace") {
+        results.push_back({config, runInPlace(config, options)});
+      }
+      else {
+        results.push_back({config, runAddMul(config, options, !sweep)});
+      }
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  if (sweep && !results.empty()) {
+    printSweepResults(results);
+  }
+
+  std::vector<ResultSet> resultSets = scalingSets;
+  for (const auto& result : results) {
+    resultSets.push_back({result.config.parameters(), result.profiles});
+  }
+  writeResults(args, "bench-add-mul", resultSets);
 
   return 0;
 }
\ No newline at end of file
@@ -32,38 +32,92 @@
 #define PROFILE
 
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <chrono>
+#include <string>
 #include <vector>
 #include <iomanip>
 
 #include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
 #include "openfhe.h"
 
 using namespace lbcrypto;
 
-int main()
+// One point of the bootstrapping sweep.
+struct BootConfig {
+  std::vector<uint32_t> levelBudget = {4, 4};
+  uint32_t numSlots = (1 << 15);
+  SecretKeyDist secretKeyDist = UNIFORM_TERNARY;
+  uint32_t numIterations = 1;
+
+  std::string label() const {
+    return "levelBudget={" + std::to_string(levelBudget[0]) + "," + std::to_string(levelBudget[1]) + "}" +
+           " slots=" + std::to_string(numSlots) +
+           " " + secretKeyDistName() +
+           " iterations=" + std::to_string(numIterations) +
+           " " + scalingTechniqueName(scalingTechnique());
+  }
+
+  // iterative bootstrapping follows the OpenFHE example, which uses FLEXIBLEAUTO;
+  // a single iteration keeps the library default
+  ScalingTechnique scalingTechnique() const {
+    return numIterations > 1 ? FLEXIBLEAUTO : FLEXIBLEAUTOEXT;
+  }
+
+  std::string secretKeyDistName() const {
+    return secretKeyDist == UNIFORM_TERNARY ? "UNIFORM_TERNARY" : "SPARSE_TERNARY";
+  }
+};
+
+struct BootResult {
+  BootConfig config;
+  uint32_t depth;
+  uint32_t levelsAfter;
+  double estimatedPrecision;
+  double measuredPrecision;
+  size_t bootstrapKeyBytes;
+  ProfileData profile;
+};
+
+// Precision in bits of the first numSlots decrypted values relative to the input.
+static double measurePrecision(const Plaintext& result, const std::vector<double>& expected)
 {
-  uint32_t numRuns = 2;
-  std::vector<ProfileData> profiles;
+  std::vector<double> values = result->GetRealPackedValue();
+  double maxError = 0;
+  for (size_t i = 0; i < expected.size() && i < values.size(); i++) {
+    maxError = std::max(maxError, std::fabs(values[i] - expected[i]));
+  }
+  return -std::log2(maxError);
+}
 
+static BootResult runBootstrap(const BootConfig& boot, const BenchArgs& args, const ProfileOptions& options, bool verbose)
+{
+  std::string mode = args.get("mode", "latency");
   uint32_t scaleModSize = 59;
   uint32_t firstModSize = 60;
-  uint32_t batchSize = (1 << 15);
-  std::vector<uint32_t> levelBudget = {4, 4};
-  SecretKeyDist secretKeyDist = UNIFORM_TERNARY;
+  uint32_t ringDim = (1 << args.getUInt("log-ring-dim", 16));
+  uint32_t batchSize = boot.numSlots;
+  std::vector<uint32_t> levelBudget = boot.levelBudget;
+  SecretKeyDist secretKeyDist = boot.secretKeyDist;
 
   CCParams<CryptoContextCKKSRNS> parameters;
   parameters.SetFirstModSize(firstModSize);
   parameters.SetScalingModSize(scaleModSize);
   parameters.SetBatchSize(batchSize);
   parameters.SetSecurityLevel(HEStd_NotSet);
-  parameters.SetRingDim(2 * batchSize);
+  parameters.SetRingDim(ringDim);
   // parameters.SetKeySwitchTechnique(HYBRID);
   parameters.SetSecretKeyDist(secretKeyDist);
+  parameters.SetScalingTechnique(boot.scalingTechnique());
 
+  // every extra iteration consumes one more level
   uint32_t levelsAvailableAfterBootstrap = 3;
-  usint depth = levelsAvailableAfterBootstrap + FHECKKSRNS::GetBootstrapDepth(levelBudget, secretKeyDist);
+  usint depth = levelsAvailableAfterBootstrap + FHECKKSRNS::GetBootstrapDepth(levelBudget, secretKeyDist) +
+                (boot.numIterations - 1);
   std::cout << "Total circuit depth: " << depth << "\n";
   parameters.SetMultiplicativeDepth(depth);
 
@@ -74,78 +128,232 @@ int main()
   cc->Enable(ADVANCEDSHE);
   cc->Enable(FHE);
 
-  std::cout << "\n\nNote this build is SINGLE-THREADED \n\n";
+  printThreadingInfo();
   std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl
             << std::endl;
 
-  cc->EvalBootstrapSetup(levelBudget);
+  cc->EvalBootstrapSetup(levelBudget, {0, 0}, batchSize);
 
   auto keys = cc->KeyGen();
-  auto print_moduli_chain = [](const DCRTPoly &poly)
-  {
-    int num_primes = poly.GetNumOfElements();
-    double total_bit_len = 0.0;
-    for (int i = 0; i < num_primes; i++)
-    {
-      auto qi = poly.GetParams()->GetParams()[i]->GetModulus();
-      std::cout << "q_" << i << ": "
-                << qi
-                << ",  log q_" << i << ": " << log(qi.ConvertToDouble()) / log(2)
-                << std::endl;
-      total_bit_len += log(qi.ConvertToDouble()) / log(2);
-    }
-    std::cout << "Total bit length: " << total_bit_len << std::endl;
-  };
   const std::vector<DCRTPoly> &ckks_pk = keys.publicKey->GetPublicElements();
   std::cout << "Moduli chain of pk: " << std::endl;
-  print_moduli_chain(ckks_pk[0]);
+  printModuliChain(ckks_pk[0]);
 
   cc->EvalMultKeyGen(keys.secretKey);
   cc->EvalBootstrapKeyGen(keys.secretKey, batchSize);
 
+  BootResult result;
+  result.config = boot;
+  result.depth = depth;
+  result.bootstrapKeyBytes = serializedEvalMultKeySize() + serializedEvalAutomorphismKeySize();
+
   uint32_t seed = 42;
   std::vector<double> x1 = generateRandomDoubleVector(batchSize, seed);
 
-  Plaintext ptxt1 = cc->MakeCKKSPackedPlaintext(x1, 1, depth - 1);
+  Plaintext ptxt1 = cc->MakeCKKSPackedPlaintext(x1, 1, depth - 1, nullptr, batchSize);
 
-  std::cout << "Input x1: " << ptxt1 << std::endl;
+  if (verbose) {
+    std::cout << "Input x1: " << ptxt1 << std::endl;
+  }
 
   auto c1 = cc->Encrypt(keys.publicKey, ptxt1);
   std::cout << "Initial number of levels remaining: " << depth - c1->GetLevel() << std::endl;
 
-  ProfileData evalBootProfile;
-  evalBootProfile.operationName = "EvalBootstrap";
-  {
-    double sum = 0;
-    for (uint32_t i = 0; i < numRuns; i++)
-    {
-      auto start = std::chrono::high_resolution_clock::now();
-      auto ciphertextAfter = cc->EvalBootstrap(c1);
-      auto end = std::chrono::high_resolution_clock::now();
-      sum += std::chrono::duration<double, std::milli>(end - start).count();
+  // iterative bootstrapping needs the precision of a single iteration as input
+  uint32_t singlePrecision = 0;
+  if (boot.numIterations > 1) {
+    Plaintext single;
+    cc->Decrypt(keys.secretKey, cc->EvalBootstrap(c1), &single);
+    singlePrecision = static_cast<uint32_t>(std::floor(measurePrecision(single, x1)));
+    std::cout << "Single-iteration precision: " << singlePrecision << " bits" << std::endl;
+  }
+  auto bootstrap = [&cc, &c1, &boot, singlePrecision] {
+    return cc->EvalBootstrap(c1, boot.numIterations, singlePrecision);
+  };
+
+  if (mode == "threads") {
+    // intra-op scaling of a single bootstrap over the OpenMP thread count
+    std::vector<uint32_t> threadCounts = args.getUIntList("threads", defaultThreadCounts(maxIntraOpThreads()));
+    std::vector<ScalingRow> rows;
+    double baseline = 0;
+    uint32_t intraOpThreads = currentIntraOpThreads();
+    IntraOpAffinity affinity = saveIntraOpAffinity(*std::max_element(threadCounts.begin(), threadCounts.end()));
+    for (uint32_t threads : threadCounts) {
+      setIntraOpThreads(threads);
+      pinIntraOpThreads(threads);
+      double latency = measureOperation("EvalBootstrap", options, bootstrap).stats.median;
+      if (baseline == 0) {
+        baseline = latency * threads;
+      }
+      double speedup = baseline / latency;
+      rows.push_back({"EvalBootstrap", threads, latency, speedup, speedup / threads});
     }
-    evalBootProfile.avgTimeExcludingFirst = sum / (numRuns);
-    profiles.push_back(evalBootProfile);
+    setIntraOpThreads(intraOpThreads);
+    restoreIntraOpAffinity(affinity);
+    printScalingResults(rows);
   }
 
-  auto ciphertextAfter = cc->EvalBootstrap(c1);
+  result.profile = measureOperation("EvalBootstrap", options, bootstrap);
+
+  auto ciphertextAfter = bootstrap();
+  result.profile.outputBytes = serializedSize(ciphertextAfter);
+  result.levelsAfter = depth - ciphertextAfter->GetLevel();
 
-  Plaintext result;
+  Plaintext decrypted;
   std::cout.precision(8);
   std::cout << std::endl
             << "Results of homomorphic computations: " << std::endl;
 
-  cc->Decrypt(keys.secretKey, c1, &result);
-  result->SetLength(batchSize);
-  std::cout << "x1 = " << result;
-  std::cout << "Estimated precision in bits: " << result->GetLogPrecision() << std::endl;
+  cc->Decrypt(keys.secretKey, c1, &decrypted);
+  decrypted->SetLength(batchSize);
+  if (verbose) {
+    std::cout << "x1 = " << decrypted;
+  }
+  std::cout << "Estimated precision in bits: " << decrypted->GetLogPrecision() << std::endl;
+
+  cc->Decrypt(keys.secretKey, ciphertextAfter, &decrypted);
+  decrypted->SetLength(batchSize);
+  if (verbose) {
+    std::cout << "Bootstrapped x1 = " << decrypted;
+  }
+  std::cout << "Estimated precision in bits: " << decrypted->GetLogPrecision() << std::endl;
+  std::cout << "Levels remaining after bootstrapping: " << result.levelsAfter << std::endl;
+  result.estimatedPrecision = decrypted->GetLogPrecision();
+  result.measuredPrecision = measurePrecision(decrypted, x1);
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  return result;
+}
+
+static void printBootstrapResults(const std::vector<BootResult>& results)
+{
+  std::cout << "\n============ Bootstrapping Configuration Results ============\n";
+  std::cout << std::left << std::setw(9) << "Budget"
+            << std::right << std::setw(8) << "Slots"
+            << std::right << std::setw(17) << "Secret key"
+            << std::right << std::setw(7) << "Iter"
+            << std::right << std::setw(17) << "Scaling"
+            << std::right << std::setw(7) << "Depth"
+            << std::right << std::setw(13) << "Levels left"
+            << std::right << std::setw(15) << "Median (ms)"
+            << std::right << std::setw(12) << "P99 (ms)"
+            << std::right << std::setw(15) << "Est. prec."
+            << std::right << std::setw(15) << "Meas. prec."
+            << std::right << std::setw(14) << "Keys (MB)" << std::endl;
+  std::cout << std::string(149, '-') << std::endl;
+
+  for (const auto& result : results) {
+    const BootConfig& boot = result.config;
+    std::cout << std::left << std::setw(9) << ("{" + std::to_string(boot.levelBudget[0]) + "," + std::to_string(boot.levelBudget[1]) + "}")
+              << std::right << std::setw(8) << boot.numSlots
+              << std::right << std::setw(17) << boot.secretKeyDistName()
+              << std::right << std::setw(7) << boot.numIterations
+              << std::right << std::setw(17) << scalingTechniqueName(boot.scalingTechnique())
+              << std::right << std::setw(7) << result.depth
+              << std::right << std::setw(13) << result.levelsAfter
+              << std::right << std::fixed << std::setprecision(3) << std::setw(15) << result.profile.stats.median
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << result.profile.stats.p99
+              << std::right << std::fixed << std::setprecision(2) << std::setw(15) << result.estimatedPrecision
+              << std::right << std::fixed << std::setprecision(2) << std::setw(15) << result.measuredPrecision
+              << std::right << std::fixed << std::setprecision(1) << std::setw(14) << result.bootstrapKeyBytes / double(1 << 20) << std::endl;
+  }
+  std::cout << std::string(149, '-') << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  // bootstrapping is slow: no warmup run, two timed runs unless overridden
+  ProfileOptions defaults;
+  defaults.warmupRuns = 0;
+  defaults.minRuns = 2;
+  defaults.maxRuns = 2;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  // level budgets are given as "b" for {b,b} or "a/b" for {a,b}
+  std::vector<std::vector<uint32_t>> levelBudgets;
+  for (const auto& item : args.getList("level-budget", {"4"})) {
+    size_t slash = item.find('/');
+    if (slash == std::string::npos) {
+      for (uint32_t b : parseUIntList(item)) {
+        levelBudgets.push_back({b, b});
+      }
+    }
+    else {
+      levelBudgets.push_back({static_cast<uint32_t>(std::stoul(item.substr(0, slash))),
+                              static_cast<uint32_t>(std::stoul(item.substr(slash + 1)))});
+    }
+  }
+  std::vector<uint32_t> logSlots = args.getUIntList("log-slots", {15});
+  std::vector<uint32_t> iterations = args.getUIntList("iterations", {1});
+  std::vector<SecretKeyDist> secretKeyDists;
+  for (const auto& name : args.getList("key-dist", {"UNIFORM_TERNARY"})) {
+    if (name == "UNIFORM_TERNARY") {
+      secretKeyDists.push_back(UNIFORM_TERNARY);
+    }
+    else if (name == "SPARSE_TERNARY") {
+      secretKeyDists.push_back(SPARSE_TERNARY);
+    }
+    else {
+      throw std::invalid_argument("Unknown secret key distribution: " + name);
+    }
+  }
+
+  std::vector<BootConfig> grid;
+  for (const auto& levelBudget : levelBudgets) {
+    for (uint32_t logSlot : logSlots) {
+      for (SecretKeyDist secretKeyDist : secretKeyDists) {
+        for (uint32_t numIterations : iterations) {
+          BootConfig boot;
+          boot.levelBudget = levelBudget;
+          boot.numSlots = (1 << logSlot);
+          boot.secretKeyDist = secretKeyDist;
+          boot.numIterations = numIterations;
+          grid.push_back(boot);
+        }
+      }
+    }
+  }
+  bool sweep = grid.size() > 1;
 
-  cc->Decrypt(keys.secretKey, ciphertextAfter, &result);
-  result->SetLength(batchSize);
-  std::cout << "Bootstrapped x1 = " << result;
-  std::cout << "Estimated precision in bits: " << result->GetLogPrecision() << std::endl;
+  std::vector<BootResult> results;
+  for (const auto& boot : grid) {
+    std::cout << "\n============ Configuration: " << boot.label() << " ============\n";
+    try {
+      results.push_back(runBootstrap(boot, args, options, !sweep));
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << boot.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  std::vector<ProfileData> profiles;
+  std::vector<ResultSet> resultSets;
+  for (const auto& result : results) {
+    profiles.push_back(result.profile);
+    const BootConfig& boot = result.config;
+    ParameterList parameterList = {
+      {"ring_dim", std::to_string(1 << args.getUInt("log-ring-dim", 16))},
+      {"mult_depth", std::to_string(result.depth)},
+      {"scale_mod_size", "59"},
+      {"first_mod_size", "60"},
+      {"batch_size", std::to_string(boot.numSlots)},
+      {"level_budget", std::to_string(boot.levelBudget[0]) + "/" + std::to_string(boot.levelBudget[1])},
+      {"secret_key_dist", boot.secretKeyDistName()},
+      {"iterations", std::to_string(boot.numIterations)},
+      {"scaling", scalingTechniqueName(boot.scalingTechnique())},
+    };
+    resultSets.push_back({parameterList, {result.profile}});
+  }
 
   printProfileResults(profiles);
+  if (sweep) {
+    printBootstrapResults(results);
+  }
+  writeResults(args, "bench-boots", resultSets);
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,681 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Client/server split of a CKKS workload on one host. A server process holds
+// only the context, the evaluation keys and an encrypted operand; N client
+// processes hold the key pair, encrypt requests, send them over a Unix-domain
+// socket and decrypt the responses. Everything crossing a process boundary is
+// serialized. Reports end-to-end request latency percentiles, server and
+// end-to-end throughput and the split of each request into serialization, transfer, compute and
+// deserialization time.
+//
+// All processes are forked by a per-configuration coordinator before it touches
+// OpenFHE, so no child inherits a running OpenMP thread pool.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "mapped-file.h"
+#include "results.h"
+#include "openfhe.h"
+
+#include "ciphertext-ser.h"
+#include "cryptocontext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+using namespace lbcrypto;
+using Clock = std::chrono::steady_clock;
+
+enum MessageType : uint32_t {
+  SETUP = 1,
+  READY,
+  REQUEST,
+  RESPONSE,
+  DONE,
+  RESULTS,
+};
+
+struct RequestTiming {
+  double encryptMs;
+  double serializeMs;
+  // round trip less the server's processing: socket transfer and waiting for a handler
+  double transferMs;
+  double serverDeserializeMs;
+  double computeMs;
+  double serverSerializeMs;
+  double deserializeMs;
+  double decryptMs;
+  double endToEndMs;
+  // steady clock, which is shared by every process on the host
+  int64_t startNs;
+  int64_t endNs;
+  int64_t serverStartNs;
+  int64_t serverEndNs;
+  uint64_t requestBytes;
+  uint64_t responseBytes;
+};
+
+// Server-side timings, sent in front of every response.
+struct ServerTiming {
+  double deserializeMs;
+  double computeMs;
+  double serializeMs;
+  // steady clock, from the start of deserialization to the serialized response
+  int64_t startNs;
+  int64_t endNs;
+};
+
+struct SetupInfo {
+  uint64_t serverBytes;
+  uint64_t clientBytes;
+  double serverDeserializeMs;
+};
+
+static int64_t steadyNs(Clock::time_point time)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+static double elapsedMs(Clock::time_point start, Clock::time_point end)
+{
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void writeAll(int fd, const void* data, size_t size)
+{
+  const char* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+    if (written < 0) {
+      throw std::runtime_error(std::string("send failed: ") + std::strerror(errno));
+    }
+    bytes += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+static void readAll(int fd, void* data, size_t size)
+{
+  char* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t received = recv(fd, bytes, size, 0);
+    if (received <= 0) {
+      throw std::runtime_error(received == 0 ? "Connection closed by peer" : std::string("recv failed: ") + std::strerror(errno));
+    }
+    bytes += received;
+    size -= static_cast<size_t>(received);
+  }
+}
+
+// Messages are a 4-byte type and an 8-byte length followed by the payload.
+static void sendMessage(int fd, uint32_t type, const std::string& payload)
+{
+  char header[12];
+  uint64_t length = payload.size();
+  std::memcpy(header, &type, sizeof(type));
+  std::memcpy(header + sizeof(type), &length, sizeof(length));
+  writeAll(fd, header, sizeof(header));
+  writeAll(fd, payload.data(), payload.size());
+}
+
+static uint32_t receiveMessage(int fd, std::string& payload)
+{
+  char header[12];
+  readAll(fd, header, sizeof(header));
+  uint32_t type;
+  uint64_t length;
+  std::memcpy(&type, header, sizeof(type));
+  std::memcpy(&length, header + sizeof(type), sizeof(length));
+  payload.resize(length);
+  readAll(fd, &payload[0], length);
+  return type;
+}
+
+static void expectMessage(int fd, uint32_t type, std::string& payload)
+{
+  if (receiveMessage(fd, payload) != type) {
+    throw std::runtime_error("Unexpected message type");
+  }
+}
+
+template <typename T>
+static std::string serialize(const T& object)
+{
+  std::ostringstream os;
+  Serial::Serialize(object, os, SerType::BINARY);
+  return os.str();
+}
+
+template <typename T>
+static T deserialize(const std::string& payload)
+{
+  MemoryStreamBuf buffer(payload.data(), payload.size());
+  std::istream is(&buffer);
+  T object;
+  Serial::Deserialize(object, is, SerType::BINARY);
+  return object;
+}
+
+// Forks a child running body, which exits with status 1 if body throws.
+static pid_t forkProcess(const std::string& role, const std::function<void()>& body)
+{
+  std::cout.flush();
+  pid_t pid = fork();
+  if (pid < 0) {
+    throw std::runtime_error(std::string("fork failed: ") + std::strerror(errno));
+  }
+  if (pid == 0) {
+    int status = 0;
+    try {
+      body();
+    }
+    catch (const std::exception& e) {
+      std::cerr << role << ": " << e.what() << std::endl;
+      status = 1;
+    }
+    std::cout.flush();
+    _exit(status);
+  }
+  return pid;
+}
+
+// The compute step applies --compute in order to the request: "add" adds the
+// server's operand, "mult" multiplies by it, "square" squares, "rotate" rotates by one slot.
+static Ciphertext<DCRTPoly> compute(const CryptoContext<DCRTPoly>& cc, Ciphertext<DCRTPoly> ciphertext,
+                                    const Ciphertext<DCRTPoly>& operand, const std::vector<std::string>& steps)
+{
+  for (const auto& step : steps) {
+    if (step == "add") {
+      ciphertext = cc->EvalAdd(ciphertext, operand);
+    }
+    else if (step == "mult") {
+      ciphertext = cc->EvalMult(ciphertext, operand);
+    }
+    else if (step == "square") {
+      ciphertext = cc->EvalSquare(ciphertext);
+    }
+    else {
+      ciphertext = cc->EvalRotate(ciphertext, 1);
+    }
+  }
+  return ciphertext;
+}
+
+static void serveClient(int fd, const CryptoContext<DCRTPoly>& cc, const Ciphertext<DCRTPoly>& operand,
+                        const std::vector<std::string>& steps)
+{
+  std::string payload;
+  while (receiveMessage(fd, payload) == REQUEST) {
+    ServerTiming timing;
+    auto start = Clock::now();
+    Ciphertext<DCRTPoly> request = deserialize<Ciphertext<DCRTPoly>>(payload);
+    auto deserialized = Clock::now();
+    Ciphertext<DCRTPoly> result = compute(cc, request, operand, steps);
+    auto computed = Clock::now();
+    std::string response = serialize(result);
+    auto serialized = Clock::now();
+    timing.deserializeMs = elapsedMs(start, deserialized);
+    timing.computeMs = elapsedMs(deserialized, computed);
+    timing.serializeMs = elapsedMs(computed, serialized);
+    timing.startNs = steadyNs(start);
+    timing.endNs = steadyNs(serialized);
+    sendMessage(fd, RESPONSE, std::string(reinterpret_cast<const char*>(&timing), sizeof(timing)) + response);
+  }
+  close(fd);
+}
+
+// The first connection is the key owner's setup: context, relinearization and
+// rotation keys and the encrypted operand. Every later connection is a client,
+// served by its own thread.
+static void runServer(int listenFd, uint32_t numClients, const std::vector<std::string>& steps)
+{
+  int setupFd = accept(listenFd, nullptr, nullptr);
+  if (setupFd < 0) {
+    throw std::runtime_error(std::string("accept failed: ") + std::strerror(errno));
+  }
+  std::string context, multKeys, rotationKeys, operandBytes;
+  expectMessage(setupFd, SETUP, context);
+  expectMessage(setupFd, SETUP, multKeys);
+  expectMessage(setupFd, SETUP, rotationKeys);
+  expectMessage(setupFd, SETUP, operandBytes);
+
+  auto start = Clock::now();
+  CryptoContext<DCRTPoly> cc = deserialize<CryptoContext<DCRTPoly>>(context);
+  {
+    MemoryStreamBuf buffer(multKeys.data(), multKeys.size());
+    std::istream is(&buffer);
+    CryptoContextImpl<DCRTPoly>::DeserializeEvalMultKey(is, SerType::BINARY);
+  }
+  {
+    MemoryStreamBuf buffer(rotationKeys.data(), rotationKeys.size());
+    std::istream is(&buffer);
+    CryptoContextImpl<DCRTPoly>::DeserializeEvalAutomorphismKey(is, SerType::BINARY);
+  }
+  Ciphertext<DCRTPoly> operand = deserialize<Ciphertext<DCRTPoly>>(operandBytes);
+  double setupMs = elapsedMs(start, Clock::now());
+  sendMessage(setupFd, READY, std::string(reinterpret_cast<const char*>(&setupMs), sizeof(setupMs)));
+  close(setupFd);
+
+  std::vector<std::thread> handlers;
+  for (uint32_t i = 0; i < numClients; i++) {
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) {
+      throw std::runtime_error(std::string("accept failed: ") + std::strerror(errno));
+    }
+    handlers.emplace_back([fd, &cc, &operand, &steps] {
+      try {
+        serveClient(fd, cc, operand, steps);
+      }
+      catch (const std::exception& e) {
+        std::cerr << "server: " << e.what() << std::endl;
+        close(fd);
+      }
+    });
+  }
+  for (auto& handler : handlers) {
+    handler.join();
+  }
+  close(listenFd);
+}
+
+static int connectTo(const std::string& socketPath)
+{
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+  if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+    throw std::runtime_error("Cannot connect to " + socketPath + ": " + std::strerror(errno));
+  }
+  return fd;
+}
+
+// Receives the context and key pair from the key owner over controlFd, sends
+// numRequests requests one after the other and returns the timings over controlFd.
+static void runClient(int controlFd, const std::string& socketPath, uint32_t numRequests, uint32_t batchSize, uint32_t seed)
+{
+  std::string payload;
+  expectMessage(controlFd, SETUP, payload);
+  CryptoContext<DCRTPoly> cc = deserialize<CryptoContext<DCRTPoly>>(payload);
+  expectMessage(controlFd, SETUP, payload);
+  PublicKey<DCRTPoly> publicKey = deserialize<PublicKey<DCRTPoly>>(payload);
+  expectMessage(controlFd, SETUP, payload);
+  PrivateKey<DCRTPoly> secretKey = deserialize<PrivateKey<DCRTPoly>>(payload);
+
+  std::vector<double> input = generateRandomDoubleVector(batchSize, seed);
+  int fd = connectTo(socketPath);
+  std::vector<RequestTiming> timings;
+  for (uint32_t i = 0; i < numRequests; i++) {
+    RequestTiming timing;
+    auto start = Clock::now();
+    Ciphertext<DCRTPoly> request = cc->Encrypt(publicKey, cc->MakeCKKSPackedPlaintext(input));
+    auto encrypted = Clock::now();
+    std::string requestBytes = serialize(request);
+    auto serialized = Clock::now();
+    sendMessage(fd, REQUEST, requestBytes);
+    expectMessage(fd, RESPONSE, payload);
+    auto received = Clock::now();
+    ServerTiming server;
+    std::memcpy(&server, payload.data(), sizeof(server));
+    Ciphertext<DCRTPoly> response = deserialize<Ciphertext<DCRTPoly>>(payload.substr(sizeof(server)));
+    auto deserialized = Clock::now();
+    Plaintext result;
+    cc->Decrypt(secretKey, response, &result);
+    auto end = Clock::now();
+
+    timing.encryptMs = elapsedMs(start, encrypted);
+    timing.serializeMs = elapsedMs(encrypted, serialized);
+    timing.serverDeserializeMs = server.deserializeMs;
+    timing.computeMs = server.computeMs;
+    timing.serverSerializeMs = server.serializeMs;
+    timing.transferMs = elapsedMs(serialized, received) - server.deserializeMs - server.computeMs - server.serializeMs;
+    timing.deserializeMs = elapsedMs(received, deserialized);
+    timing.decryptMs = elapsedMs(deserialized, end);
+    timing.endToEndMs = elapsedMs(start, end);
+    timing.startNs = steadyNs(start);
+    timing.endNs = steadyNs(end);
+    timing.serverStartNs = server.startNs;
+    timing.serverEndNs = server.endNs;
+    timing.requestBytes = requestBytes.size();
+    timing.responseBytes = payload.size() - sizeof(server);
+    timings.push_back(timing);
+  }
+  sendMessage(fd, DONE, "");
+  close(fd);
+
+  sendMessage(controlFd, RESULTS,
+              std::string(reinterpret_cast<const char*>(timings.data()), timings.size() * sizeof(RequestTiming)));
+}
+
+// Generates the keys, sends the server its setup and every client its key pair,
+// then forwards the setup summary and all client timings to resultFd.
+static void distributeAndCollect(int resultFd, const CKKSConfig& config, const std::string& socketPath,
+                                 const std::vector<int>& controlFds)
+{
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  KeyPair<DCRTPoly> keys = cc->KeyGen();
+  cc->EvalMultKeyGen(keys.secretKey);
+  cc->EvalRotateKeyGen(keys.secretKey, {1});
+  Plaintext operand = cc->MakeCKKSPackedPlaintext(generateRandomDoubleVector(config.batchSize, 7));
+
+  SetupInfo setup;
+  std::string context = serialize(cc);
+  std::ostringstream multKeys, rotationKeys;
+  CryptoContextImpl<DCRTPoly>::SerializeEvalMultKey(multKeys, SerType::BINARY);
+  CryptoContextImpl<DCRTPoly>::SerializeEvalAutomorphismKey(rotationKeys, SerType::BINARY);
+  std::string operandBytes = serialize(cc->Encrypt(keys.publicKey, operand));
+  int setupFd = connectTo(socketPath);
+  for (const std::string& part : {context, multKeys.str(), rotationKeys.str(), operandBytes}) {
+    sendMessage(setupFd, SETUP, part);
+  }
+  setup.serverBytes = context.size() + multKeys.str().size() + rotationKeys.str().size() + operandBytes.size();
+  std::string payload;
+  expectMessage(setupFd, READY, payload);
+  std::memcpy(&setup.serverDeserializeMs, payload.data(), sizeof(setup.serverDeserializeMs));
+  close(setupFd);
+
+  std::string publicKey = serialize(keys.publicKey);
+  std::string secretKey = serialize(keys.secretKey);
+  setup.clientBytes = context.size() + publicKey.size() + secretKey.size();
+  for (int fd : controlFds) {
+    sendMessage(fd, SETUP, context);
+    sendMessage(fd, SETUP, publicKey);
+    sendMessage(fd, SETUP, secretKey);
+  }
+
+  std::string results(reinterpret_cast<const char*>(&setup), sizeof(setup));
+  for (int fd : controlFds) {
+    expectMessage(fd, RESULTS, payload);
+    results += payload;
+    close(fd);
+  }
+  sendMessage(resultFd, RESULTS, results);
+}
+
+// Runs in its own process for every configuration: forks the server and the
+// clients before touching OpenFHE, then distributes the keys and collects the timings.
+static void runCoordinator(int resultFd, const CKKSConfig& config, uint32_t numClients, uint32_t numRequests,
+                           const std::vector<std::string>& steps)
+{
+  std::string socketPath = (std::filesystem::temp_directory_path() / ("bench-client-server-" + std::to_string(getpid()) + ".sock")).string();
+  int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+  unlink(socketPath.c_str());
+  if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+      listen(listenFd, static_cast<int>(numClients) + 1) < 0) {
+    throw std::runtime_error("Cannot listen on " + socketPath + ": " + std::strerror(errno));
+  }
+
+  std::vector<pid_t> children;
+  children.push_back(forkProcess("server", [&] {
+    close(resultFd);
+    runServer(listenFd, numClients, steps);
+  }));
+  close(listenFd);
+
+  std::vector<int> controlFds;
+  for (uint32_t i = 0; i < numClients; i++) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+      throw std::runtime_error(std::string("socketpair failed: ") + std::strerror(errno));
+    }
+    children.push_back(forkProcess("client " + std::to_string(i), [&] {
+      close(fds[0]);
+      close(resultFd);
+      runClient(fds[1], socketPath, numRequests, config.batchSize, 42 + i);
+    }));
+    close(fds[1]);
+    controlFds.push_back(fds[0]);
+  }
+
+  try {
+    distributeAndCollect(resultFd, config, socketPath, controlFds);
+  }
+  catch (const std::exception&) {
+    // a server blocked in accept or a client waiting for its keys would never exit
+    for (pid_t child : children) {
+      kill(child, SIGTERM);
+      waitpid(child, nullptr, 0);
+    }
+    unlink(socketPath.c_str());
+    throw;
+  }
+
+  bool failed = false;
+  for (pid_t child : children) {
+    int status = 0;
+    waitpid(child, &status, 0);
+    failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+  }
+  unlink(socketPath.c_str());
+  if (failed) {
+    throw std::runtime_error("Server or client process failed");
+  }
+}
+
+static ProfileData phaseProfile(const std::string& name, const std::vector<RequestTiming>& timings,
+                                double RequestTiming::*field)
+{
+  std::vector<double> samples;
+  for (const auto& timing : timings) {
+    samples.push_back(timing.*field);
+  }
+  ProfileData profile;
+  profile.operationName = name;
+  profile.stats = computeRunStats(samples, ProfileOptions().outlierThreshold);
+  profile.avgTimeExcludingFirst = profile.stats.mean;
+  profile.firstRunTime = samples.empty() ? 0 : samples.front();
+  return profile;
+}
+
+// The request phases in order, ending with the whole request.
+static const std::vector<std::pair<std::string, double RequestTiming::*>> requestPhases = {
+  {"Encrypt", &RequestTiming::encryptMs},
+  {"Serialize (client)", &RequestTiming::serializeMs},
+  {"Transfer", &RequestTiming::transferMs},
+  {"Deserialize (server)", &RequestTiming::serverDeserializeMs},
+  {"Compute", &RequestTiming::computeMs},
+  {"Serialize (server)", &RequestTiming::serverSerializeMs},
+  {"Deserialize (client)", &RequestTiming::deserializeMs},
+  {"Decrypt", &RequestTiming::decryptMs},
+  {"End-to-end", &RequestTiming::endToEndMs},
+};
+
+static double sum(const std::vector<RequestTiming>& timings, double RequestTiming::*field)
+{
+  double total = 0;
+  for (const auto& timing : timings) {
+    total += timing.*field;
+  }
+  return total;
+}
+
+// Completed requests per second between the earliest start and the latest end:
+// client timestamps give end-to-end throughput, server timestamps server throughput.
+static double requestsPerSecond(const std::vector<RequestTiming>& timings, int64_t RequestTiming::*start,
+                                int64_t RequestTiming::*end)
+{
+  int64_t firstStart = timings.front().*start;
+  int64_t lastEnd = timings.front().*end;
+  for (const auto& timing : timings) {
+    firstStart = std::min(firstStart, timing.*start);
+    lastEnd = std::max(lastEnd, timing.*end);
+  }
+  return timings.size() / ((lastEnd - firstStart) / 1e9);
+}
+
+static void printClientServerResults(const std::vector<ProfileData>& phases, const SetupInfo& setup,
+                                     const std::vector<RequestTiming>& timings, uint32_t numClients)
+{
+  double requestBytes = 0;
+  double responseBytes = 0;
+  for (const auto& timing : timings) {
+    requestBytes += timing.requestBytes;
+    responseBytes += timing.responseBytes;
+  }
+  // shares come from untrimmed sums, so that they add up to the whole request
+  double endToEndMs = sum(timings, &RequestTiming::endToEndMs);
+
+  std::cout << "\n============ Request Phases (ms) ============\n";
+  std::cout << std::left << std::setw(24) << "Phase"
+            << std::right << std::setw(10) << "Mean"
+            << std::right << std::setw(10) << "Median"
+            << std::right << std::setw(10) << "P90"
+            << std::right << std::setw(10) << "P99"
+            << std::right << std::setw(10) << "Share" << std::endl;
+  std::cout << std::string(74, '-') << std::endl;
+  for (size_t i = 0; i < phases.size(); i++) {
+    const ProfileData& phase = phases[i];
+    std::cout << std::left << std::setw(24) << phase.operationName
+              << std::right << std::fixed << std::setprecision(3) << std::setw(10) << phase.stats.mean
+              << std::right << std::fixed << std::setprecision(3) << std::setw(10) << phase.stats.median
+              << std::right << std::fixed << std::setprecision(3) << std::setw(10) << phase.stats.p90
+              << std::right << std::fixed << std::setprecision(3) << std::setw(10) << phase.stats.p99
+              << std::right << std::fixed << std::setprecision(1) << std::setw(9) << 100 * sum(timings, requestPhases[i].second) / endToEndMs << "%"
+              << std::endl;
+  }
+  std::cout << std::string(74, '-') << std::endl;
+  std::cout << "Requests: " << timings.size() << " from " << numClients << " client(s); server throughput "
+            << std::fixed << std::setprecision(2) << requestsPerSecond(timings, &RequestTiming::serverStartNs, &RequestTiming::serverEndNs)
+            << " requests/s, end-to-end throughput "
+            << requestsPerSecond(timings, &RequestTiming::startNs, &RequestTiming::endNs) << " requests/s" << std::endl;
+  std::cout << "Wire: " << std::setprecision(1) << requestBytes / timings.size() / 1024 << " KB per request, "
+            << responseBytes / timings.size() / 1024 << " KB per response" << std::endl;
+  std::cout << "Setup: " << setup.serverBytes / double(1 << 20) << " MB of context, eval keys and operand to the server ("
+            << std::setprecision(3) << setup.serverDeserializeMs << " ms to deserialize), "
+            << std::setprecision(1) << setup.clientBytes / double(1 << 20) << " MB of context and keys to each client" << std::endl;
+  std::cout << "Transfer is the round trip less the server's processing; it includes waiting for a busy server." << std::endl;
+  std::cout << "Server throughput spans the first request's deserialization to the last response's serialization;" << std::endl;
+  std::cout << "end-to-end throughput also includes client-side encryption and decryption." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  uint32_t numClients = args.getUInt("clients", 4);
+  uint32_t numRequests = args.getUInt("requests", 20);
+  std::vector<std::string> steps = args.getList("compute", {"mult"});
+  for (const auto& step : steps) {
+    if (step != "add" && step != "mult" && step != "square" && step != "rotate") {
+      throw std::invalid_argument("Unknown compute step: " + step);
+    }
+  }
+  std::string computeLabel;
+  for (const auto& step : steps) {
+    computeLabel += (computeLabel.empty() ? "" : "+") + step;
+  }
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    std::cout << numClients << " client process(es), " << numRequests << " request(s) each, compute: " << computeLabel << std::endl;
+    try {
+      int fds[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        throw std::runtime_error(std::string("socketpair failed: ") + std::strerror(errno));
+      }
+      pid_t coordinator = forkProcess("coordinator", [&] {
+        close(fds[0]);
+        runCoordinator(fds[1], config, numClients, numRequests, steps);
+      });
+      close(fds[1]);
+      std::string payload;
+      uint32_t type = 0;
+      try {
+        type = receiveMessage(fds[0], payload);
+      }
+      catch (const std::exception&) {
+        // the coordinator reports its own error on stderr
+      }
+      close(fds[0]);
+      waitpid(coordinator, nullptr, 0);
+      if (type != RESULTS || payload.size() < sizeof(SetupInfo)) {
+        throw std::runtime_error("coordinator failed");
+      }
+
+      SetupInfo setup;
+      std::memcpy(&setup, payload.data(), sizeof(setup));
+      std::vector<RequestTiming> timings((payload.size() - sizeof(setup)) / sizeof(RequestTiming));
+      std::memcpy(timings.data(), payload.data() + sizeof(setup), timings.size() * sizeof(RequestTiming));
+      if (timings.empty()) {
+        throw std::runtime_error("no requests completed");
+      }
+
+      std::vector<ProfileData> phases;
+      for (const auto& phase : requestPhases) {
+        phases.push_back(phaseProfile(phase.first, timings, phase.second));
+      }
+      phases[1].outputBytes = timings.front().requestBytes;
+      phases[4].opsPerSecond = requestsPerSecond(timings, &RequestTiming::serverStartNs, &RequestTiming::serverEndNs);
+      phases[5].outputBytes = timings.front().responseBytes;
+      phases.back().opsPerSecond = requestsPerSecond(timings, &RequestTiming::startNs, &RequestTiming::endNs);
+      printClientServerResults(phases, setup, timings, numClients);
+
+      ParameterList parameters = config.parameters();
+      parameters.push_back({"clients", std::to_string(numClients)});
+      parameters.push_back({"requests", std::to_string(numRequests)});
+      parameters.push_back({"compute", computeLabel});
+      resultSets.push_back({parameters, phases});
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-client-server", resultSets);
+
+  return 0;
+}
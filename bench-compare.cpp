@@ -0,0 +1,154 @@
+// Compares two CSV result files written with --csv and flags statistically
+// significant changes per (parameter set, operation).
+//
+//   ./bench-compare --base old.csv --new new.csv [--threshold 0.02]
+//
+// A change is reported when Welch's t-test on the means rejects equality at the
+// 95% level and the relative change of the mean is at least the threshold.
+// Exits with status 1 if any operation regressed.
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+struct ResultRow {
+  double mean;
+  double stddev;
+  uint32_t samples;
+};
+
+struct ResultTable {
+  std::vector<std::string> keys;  // in file order
+  std::map<std::string, ResultRow> rows;
+};
+
+static size_t columnIndex(const std::vector<std::string>& header, const std::string& name, const std::string& path) {
+  for (size_t i = 0; i < header.size(); ++i) {
+    if (header[i] == name) {
+      return i;
+    }
+  }
+  throw std::runtime_error(path + ": missing column " + name);
+}
+
+// Rows are keyed by every parameter column (those before "operation") plus the operation name.
+static ResultTable readResults(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("Cannot open results file: " + path);
+  }
+
+  ResultTable table;
+  std::vector<std::string> header;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::vector<std::string> fields = splitCSVLine(line);
+    if (header.empty()) {
+      header = fields;
+      continue;
+    }
+    size_t opIdx = columnIndex(header, "operation", path);
+    std::string key;
+    for (size_t i = 0; i < opIdx; ++i) {
+      key += header[i] + "=" + fields[i] + " ";
+    }
+    key += fields[opIdx];
+
+    ResultRow row;
+    row.mean = std::stod(fields[columnIndex(header, "mean_ms", path)]);
+    row.stddev = std::stod(fields[columnIndex(header, "stddev_ms", path)]);
+    row.samples = static_cast<uint32_t>(std::stoul(fields[columnIndex(header, "samples", path)]));
+    if (table.rows.emplace(key, row).second) {
+      table.keys.push_back(key);
+    }
+  }
+  return table;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  if (!args.has("base") || !args.has("new")) {
+    std::cerr << "Usage: " << argv[0] << " --base <old.csv> --new <new.csv> [--threshold 0.02]" << std::endl;
+    return 2;
+  }
+  double threshold = std::stod(args.get("threshold", "0.02"));
+
+  ResultTable base = readResults(args.get("base", ""));
+  ResultTable current = readResults(args.get("new", ""));
+
+  uint32_t regressions = 0;
+  uint32_t improvements = 0;
+
+  std::cout << "\n============ Result Comparison ============\n";
+  std::cout << std::left << std::setw(60) << "Operation"
+            << std::right << std::setw(14) << "Base (ms)"
+            << std::right << std::setw(14) << "New (ms)"
+            << std::right << std::setw(11) << "Change"
+            << std::right << std::setw(10) << "t"
+            << "  " << std::left << "Verdict" << std::endl;
+  std::cout << std::string(123, '-') << std::endl;
+
+  for (const auto& key : base.keys) {
+    auto it = current.rows.find(key);
+    if (it == current.rows.end()) {
+      std::cout << std::left << std::setw(60) << key << "  missing from " << args.get("new", "") << std::endl;
+      continue;
+    }
+    const ResultRow& a = base.rows.at(key);
+    const ResultRow& b = it->second;
+
+    double change = (a.mean > 0) ? (b.mean - a.mean) / a.mean : 0;
+    double varA = a.samples > 0 ? a.stddev * a.stddev / a.samples : 0;
+    double varB = b.samples > 0 ? b.stddev * b.stddev / b.samples : 0;
+    double se = std::sqrt(varA + varB);
+
+    bool significant;
+    double t = 0;
+    if (se == 0) {
+      significant = (b.mean != a.mean);
+    }
+    else {
+      t = (b.mean - a.mean) / se;
+      // Welch-Satterthwaite degrees of freedom
+      double dfDenom = (a.samples > 1 ? varA * varA / (a.samples - 1) : 0) + (b.samples > 1 ? varB * varB / (b.samples - 1) : 0);
+      uint32_t df = (dfDenom > 0) ? static_cast<uint32_t>((varA + varB) * (varA + varB) / dfDenom) : 1;
+      significant = std::fabs(t) > tQuantile95(std::max(df, 1u));
+    }
+
+    std::string verdict = "~";
+    if (significant && std::fabs(change) >= threshold) {
+      if (change > 0) {
+        verdict = "REGRESSION";
+        ++regressions;
+      }
+      else {
+        verdict = "improvement";
+        ++improvements;
+      }
+    }
+
+    std::cout << std::left << std::setw(60) << key
+              << std::right << std::fixed << std::setprecision(3) << std::setw(14) << a.mean
+              << std::right << std::fixed << std::setprecision(3) << std::setw(14) << b.mean
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << 100 * change << "%"
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << t
+              << "  " << std::left << verdict << std::endl;
+  }
+  std::cout << std::string(123, '-') << std::endl;
+  std::cout << regressions << " regression(s), " << improvements << " improvement(s) at threshold "
+            << 100 * threshold << "%" << std::endl;
+
+  return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,572 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Predicts the cost of an encrypted circuit from measured per-operation,
+// per-level latencies instead of adding up profile tables by hand.
+//
+//   ./bench-cost-model --calibration=levels.csv,boots.csv --circuit=circuit.txt [--validate]
+//                      [--where=level_budget=4/4,iterations=1]
+//
+// The calibration files are CSV results written with --csv, typically by
+// bench-levels (EvalAdd, EvalMult, Rescale, EvalRotate, ... per level) and
+// bench-boots (EvalBootstrap). The circuit file lists one step per line:
+//
+//   <op> [count] [@level]
+//
+// op is add, mult, square, rotate, relin, rescale, decrypt, bootstrap or the
+// name of any calibrated operation. mult and square rescale and consume one
+// level; rotate performs count rotations by 1..count that stay live together;
+// every other op is repeated count times. @level sets the level before the
+// step. When a mult would run past the calibrated depth, a bootstrap is
+// inserted that leaves --levels-after-bootstrap levels (default 3, as in bench-boots).
+// --validate runs the circuit on a context built from the calibration parameters
+// and reports the prediction error per step; bootstraps are predicted only.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+// Median latencies and ciphertext sizes of one calibrated parameter set.
+struct Calibration {
+  CKKSConfig config;
+  // operation -> level -> median ms
+  std::map<std::string, std::map<uint32_t, double>> latencies;
+  // level -> serialized ciphertext bytes
+  std::map<uint32_t, double> ciphertextBytes;
+
+  bool has(const std::string& operation) const {
+    return latencies.count(operation) > 0;
+  }
+  double latency(const std::string& operation, uint32_t level) const;
+  double bytes(uint32_t level) const;
+};
+
+struct CircuitStep {
+  std::string op;
+  uint32_t count = 1;
+  int32_t level = -1;  // -1: continue from the previous step
+};
+
+struct PredictedStep {
+  CircuitStep step;
+  uint32_t level = 0;
+  double latencyMs = 0;
+  // bootstraps inserted within this step where a level-consuming op ran out of depth
+  uint32_t insertedBootstraps = 0;
+  double insertedBootstrapMs = 0;
+  // ciphertexts held while this step runs: its input and outputs
+  double workingSetBytes = 0;
+};
+
+struct Prediction {
+  std::vector<PredictedStep> steps;
+  double totalMs = 0;
+  // largest per-step working set; values kept across steps are not tracked
+  double maxWorkingSetBytes = 0;
+  uint32_t bootstraps = 0;
+  uint32_t insertedBootstraps = 0;
+  uint32_t levelAfterBootstrap = 0;
+};
+
+// Linear interpolation over the levels present, extrapolated from the two nearest
+// ends; a single calibrated level is taken as constant.
+static double interpolate(const std::map<uint32_t, double>& byLevel, uint32_t level)
+{
+  if (byLevel.empty()) {
+    return 0;
+  }
+  auto exact = byLevel.find(level);
+  if (exact != byLevel.end() || byLevel.size() == 1) {
+    return exact != byLevel.end() ? exact->second : byLevel.begin()->second;
+  }
+  auto upper = byLevel.lower_bound(level);
+  if (upper == byLevel.begin()) {
+    ++upper;
+  }
+  else if (upper == byLevel.end()) {
+    --upper;
+  }
+  auto lower = std::prev(upper);
+  double slope = (upper->second - lower->second) / (double(upper->first) - double(lower->first));
+  return std::max(0.0, lower->second + slope * (double(level) - double(lower->first)));
+}
+
+double Calibration::latency(const std::string& operation, uint32_t level) const {
+  auto it = latencies.find(operation);
+  return it == latencies.end() ? 0 : interpolate(it->second, level);
+}
+
+double Calibration::bytes(uint32_t level) const {
+  level = std::min(level, config.multDepth);
+  if (!ciphertextBytes.empty()) {
+    return interpolate(ciphertextBytes, level);
+  }
+  // two polynomials of ring dimension 64-bit words per remaining tower
+  return 2.0 * config.ringDim * sizeof(uint64_t) * (config.multDepth + 1 - level);
+}
+
+static uint32_t uintColumn(const std::map<std::string, std::string>& row, const std::string& name, uint32_t defaultValue)
+{
+  auto it = row.find(name);
+  return it == row.end() || it->second.empty() ? defaultValue : static_cast<uint32_t>(std::stoul(it->second));
+}
+
+// Reads every calibration file. Rows of the first ring dimension and depth seen
+// (or of --log-ring-dim / --depth, when given) are kept; rows without a "level"
+// column are taken as level 0. --where=<column>=<value>[,...] drops rows whose
+// column holds another value, e.g. to pick one point of a bench-boots sweep.
+// Two kept rows for the same operation and level are an error.
+static Calibration readCalibration(const std::vector<std::string>& paths, const BenchArgs& args)
+{
+  Calibration calibration;
+  bool configSet = false;
+  uint32_t ringDim = args.has("log-ring-dim") ? (1u << args.getUInt("log-ring-dim", 16)) : 0;
+  uint32_t depth = args.getUInt("depth", 0);
+  std::map<std::string, std::string> where;
+  for (const auto& filter : args.getList("where", {})) {
+    size_t eq = filter.find('=');
+    if (eq == std::string::npos || eq == 0) {
+      throw std::invalid_argument("--where expects <column>=<value>, got: " + filter);
+    }
+    where[filter.substr(0, eq)] = filter.substr(eq + 1);
+  }
+
+  for (const auto& path : paths) {
+    std::ifstream in(path);
+    if (!in) {
+      throw std::runtime_error("Cannot open calibration file: " + path);
+    }
+    std::vector<std::string> header;
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      std::vector<std::string> fields = splitCSVLine(line);
+      if (header.empty()) {
+        header = fields;
+        continue;
+      }
+      std::map<std::string, std::string> row;
+      for (size_t i = 0; i < header.size() && i < fields.size(); ++i) {
+        row[header[i]] = fields[i];
+      }
+      if (row.count("operation") == 0 || row.count("median_ms") == 0) {
+        throw std::runtime_error(path + ": missing operation or median_ms column");
+      }
+
+      bool selected = true;
+      for (const auto& filter : where) {
+        auto it = row.find(filter.first);
+        if (it != row.end() && it->second != filter.second) {
+          selected = false;
+        }
+      }
+      if (!selected) {
+        continue;
+      }
+
+      uint32_t rowRingDim = uintColumn(row, "ring_dim", 0);
+      uint32_t rowDepth = uintColumn(row, "mult_depth", 0);
+      // bootstrapping results come from a deeper context and are kept whatever their depth
+      bool bootstrap = row["operation"] == "EvalBootstrap";
+      if ((ringDim != 0 && rowRingDim != ringDim) || (depth != 0 && rowDepth != depth && !bootstrap)) {
+        continue;
+      }
+      if (ringDim == 0) {
+        ringDim = rowRingDim;
+      }
+      if (!bootstrap && !configSet) {
+        depth = depth != 0 ? depth : rowDepth;
+        calibration.config.ringDim = rowRingDim;
+        calibration.config.multDepth = rowDepth;
+        calibration.config.scaleModSize = uintColumn(row, "scale_mod_size", calibration.config.scaleModSize);
+        calibration.config.firstModSize = uintColumn(row, "first_mod_size", calibration.config.firstModSize);
+        calibration.config.batchSize = uintColumn(row, "batch_size", calibration.config.batchSize);
+        calibration.config.numLargeDigits = uintColumn(row, "num_large_digits", 0);
+        if (row.count("scaling") > 0) {
+          calibration.config.scalingTechnique = scalingTechniqueFromName(row["scaling"]);
+        }
+        configSet = true;
+      }
+
+      uint32_t level = uintColumn(row, "level", 0);
+      std::map<uint32_t, double>& byLevel = calibration.latencies[row["operation"]];
+      if (byLevel.count(level) > 0) {
+        throw std::runtime_error(path + ": more than one " + row["operation"] + " row at level " + std::to_string(level) +
+                                 "; select one with --where=<column>=<value>");
+      }
+      byLevel[level] = std::stod(row["median_ms"]);
+      // EvalAdd leaves a ciphertext at its input level, so its output size is the size at that level
+      if (!bootstrap && row.count("level") > 0 && row["operation"] == "EvalAdd" && uintColumn(row, "output_bytes", 0) > 0) {
+        calibration.ciphertextBytes[level] = uintColumn(row, "output_bytes", 0);
+      }
+    }
+  }
+  if (!configSet) {
+    throw std::runtime_error("No leveled calibration rows match the requested ring dimension and depth");
+  }
+  return calibration;
+}
+
+static std::vector<CircuitStep> readCircuit(const std::string& path)
+{
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("Cannot open circuit file: " + path);
+  }
+  std::vector<CircuitStep> steps;
+  std::string line;
+  while (std::getline(in, line)) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream tokens(line);
+    CircuitStep step;
+    if (!(tokens >> step.op)) {
+      continue;
+    }
+    std::string token;
+    while (tokens >> token) {
+      if (token[0] == '@') {
+        step.level = static_cast<int32_t>(std::stoul(token.substr(1)));
+      }
+      else {
+        step.count = static_cast<uint32_t>(std::stoul(token));
+      }
+    }
+    steps.push_back(step);
+  }
+  return steps;
+}
+
+// Calibrated operation names behind the circuit keywords; anything else is taken literally.
+static std::vector<std::string> calibratedOps(const std::string& op)
+{
+  static const std::map<std::string, std::vector<std::string>> names = {
+    {"add", {"EvalAdd"}},
+    {"mult", {"EvalMult", "Rescale"}},
+    {"square", {"EvalMult", "Rescale"}},
+    {"rotate", {"EvalRotate"}},
+    {"relin", {"Relinearize"}},
+    {"rescale", {"Rescale"}},
+    {"decrypt", {"Decrypt"}},
+    {"bootstrap", {"EvalBootstrap"}},
+  };
+  auto it = names.find(op);
+  return it == names.end() ? std::vector<std::string>{op} : it->second;
+}
+
+static bool consumesLevel(const std::string& op)
+{
+  return op == "mult" || op == "square" || op == "rescale";
+}
+
+static Prediction predict(const Calibration& calibration, const std::vector<CircuitStep>& steps, uint32_t levelsAfterBootstrap)
+{
+  uint32_t maxLevel = calibration.config.multDepth;
+  if (levelsAfterBootstrap == 0 || levelsAfterBootstrap > maxLevel) {
+    throw std::invalid_argument("--levels-after-bootstrap must be between 1 and the calibrated depth");
+  }
+  Prediction prediction;
+  prediction.levelAfterBootstrap = maxLevel - levelsAfterBootstrap;
+  double bootstrapMs = calibration.latency("EvalBootstrap", 0);
+
+  std::set<std::string> missing;
+  uint32_t level = 0;
+  for (const auto& step : steps) {
+    for (const auto& name : calibratedOps(step.op)) {
+      if (!calibration.has(name) && missing.insert(name).second) {
+        std::cout << "Warning: " << name << " is not calibrated; counted as 0 ms" << std::endl;
+      }
+    }
+
+    PredictedStep predicted;
+    predicted.step = step;
+    if (step.level >= 0) {
+      level = std::min(static_cast<uint32_t>(step.level), maxLevel);
+    }
+    predicted.level = level;
+    // the input stays live next to the step's outputs: all of them for rotations, the latest otherwise
+    uint32_t outputs = step.op == "rotate" ? step.count : 1;
+    predicted.workingSetBytes = (1 + outputs) * calibration.bytes(level);
+    prediction.maxWorkingSetBytes = std::max(prediction.maxWorkingSetBytes, predicted.workingSetBytes);
+
+    for (uint32_t i = 0; i < step.count; i++) {
+      if (consumesLevel(step.op) && level == maxLevel) {
+        if (!calibration.has("EvalBootstrap") && missing.insert("EvalBootstrap").second) {
+          std::cout << "Warning: EvalBootstrap is not calibrated; inserted bootstraps counted as 0 ms" << std::endl;
+        }
+        predicted.insertedBootstraps++;
+        level = prediction.levelAfterBootstrap;
+      }
+      for (const auto& name : calibratedOps(step.op)) {
+        predicted.latencyMs += calibration.latency(name, level);
+      }
+      if (consumesLevel(step.op)) {
+        level++;
+      }
+    }
+    if (step.op == "bootstrap") {
+      prediction.bootstraps += step.count;
+      level = prediction.levelAfterBootstrap;
+    }
+
+    predicted.insertedBootstrapMs = predicted.insertedBootstraps * bootstrapMs;
+    prediction.bootstraps += predicted.insertedBootstraps;
+    prediction.insertedBootstraps += predicted.insertedBootstraps;
+    prediction.totalMs += predicted.latencyMs + predicted.insertedBootstrapMs;
+    prediction.steps.push_back(predicted);
+  }
+  return prediction;
+}
+
+// Runs every step of the prediction on a FIXEDMANUAL context with the calibration
+// parameters, bringing inputs to each step's level with LevelReduce, repeats
+// times. Returns the median latency of each step, or -1 for steps that are not
+// executed (bootstraps and uncalibrated operations). Where the prediction
+// inserted a bootstrap, the next input is taken at the post-bootstrap level
+// instead, outside the timed region.
+static std::vector<double> validate(const Calibration& calibration, const Prediction& prediction, uint32_t repeats)
+{
+  CKKSConfig config = calibration.config;
+  config.scalingTechnique = FIXEDMANUAL;
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  KeyPair<DCRTPoly> keys = cc->KeyGen();
+  cc->EvalMultKeyGen(keys.secretKey);
+  uint32_t maxRotations = 1;
+  for (const auto& predicted : prediction.steps) {
+    if (predicted.step.op == "rotate") {
+      maxRotations = std::max(maxRotations, predicted.step.count);
+    }
+  }
+  std::vector<int32_t> indices;
+  for (uint32_t i = 1; i <= maxRotations; i++) {
+    indices.push_back(static_cast<int32_t>(i));
+  }
+  cc->EvalRotateKeyGen(keys.secretKey, indices);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+
+  auto atLevel = [&cc](const Ciphertext<DCRTPoly>& c, uint32_t level) {
+    return level > 0 ? cc->LevelReduce(c, nullptr, level) : c;
+  };
+  auto timeMs = [](const std::function<void()>& op) {
+    auto start = std::chrono::high_resolution_clock::now();
+    op();
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+  };
+
+  std::vector<std::vector<double>> samples(prediction.steps.size());
+  for (uint32_t r = 0; r < repeats; r++) {
+    for (size_t s = 0; s < prediction.steps.size(); s++) {
+      const CircuitStep& step = prediction.steps[s].step;
+      uint32_t level = prediction.steps[s].level;
+      Ciphertext<DCRTPoly> a = atLevel(inputs.c1, level);
+      Ciphertext<DCRTPoly> b = atLevel(inputs.c2, level);
+      double elapsedMs = 0;
+
+      if (step.op == "mult" || step.op == "square") {
+        for (uint32_t i = 0; i < step.count; i++) {
+          if (level == config.multDepth) {
+            level = prediction.levelAfterBootstrap;
+            a = atLevel(inputs.c1, level);
+          }
+          b = atLevel(inputs.c2, level);
+          elapsedMs += timeMs([&] { a = cc->Rescale(step.op == "mult" ? cc->EvalMult(a, b) : cc->EvalMult(a, a)); });
+          level++;
+        }
+      }
+      else if (step.op == "rescale") {
+        for (uint32_t i = 0; i < step.count; i++) {
+          if (level == config.multDepth) {
+            level = prediction.levelAfterBootstrap;
+          }
+          Ciphertext<DCRTPoly> product = cc->EvalMult(atLevel(inputs.c1, level), atLevel(inputs.c2, level));
+          elapsedMs += timeMs([&] { cc->Rescale(product); });
+          level++;
+        }
+      }
+      else if (step.op == "add") {
+        elapsedMs = timeMs([&] {
+          for (uint32_t i = 0; i < step.count; i++) {
+            cc->EvalAdd(a, b);
+          }
+        });
+      }
+      else if (step.op == "rotate") {
+        elapsedMs = timeMs([&] {
+          std::vector<Ciphertext<DCRTPoly>> rotations;
+          for (uint32_t i = 1; i <= step.count; i++) {
+            rotations.push_back(cc->EvalRotate(a, static_cast<int32_t>(i)));
+          }
+        });
+      }
+      else if (step.op == "relin") {
+        Ciphertext<DCRTPoly> product = cc->EvalMultNoRelin(a, b);
+        elapsedMs = timeMs([&] {
+          for (uint32_t i = 0; i < step.count; i++) {
+            cc->Relinearize(product);
+          }
+        });
+      }
+      else if (step.op == "decrypt") {
+        elapsedMs = timeMs([&] {
+          for (uint32_t i = 0; i < step.count; i++) {
+            Plaintext result;
+            cc->Decrypt(keys.secretKey, a, &result);
+          }
+        });
+      }
+      else {
+        continue;
+      }
+      samples[s].push_back(elapsedMs);
+    }
+  }
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  std::vector<double> measured;
+  for (const auto& stepSamples : samples) {
+    measured.push_back(stepSamples.empty() ? -1 : computeRunStats(stepSamples, ProfileOptions().outlierThreshold).median);
+  }
+  return measured;
+}
+
+static void printPrediction(const Prediction& prediction, const std::vector<double>& measured)
+{
+  bool validated = !measured.empty();
+  std::cout << "\n============ Circuit Cost Prediction ============\n";
+  std::cout << std::left << std::setw(5) << "#"
+            << std::left << std::setw(12) << "Op"
+            << std::right << std::setw(7) << "Count"
+            << std::right << std::setw(7) << "Level"
+            << std::right << std::setw(15) << "Predicted ms"
+            << std::right << std::setw(11) << "Step MB";
+  if (validated) {
+    std::cout << std::right << std::setw(14) << "Measured ms"
+              << std::right << std::setw(10) << "Error";
+  }
+  std::cout << std::endl;
+  size_t width = validated ? 81 : 57;
+  std::cout << std::string(width, '-') << std::endl;
+
+  double predictedValidated = 0;
+  double measuredTotal = 0;
+  for (size_t s = 0; s < prediction.steps.size(); s++) {
+    const PredictedStep& step = prediction.steps[s];
+    if (step.insertedBootstraps > 0) {
+      std::cout << std::left << std::setw(5) << "" << std::left << std::setw(12) << "bootstrap"
+                << std::right << std::setw(7) << step.insertedBootstraps
+                << std::right << std::setw(7) << "-"
+                << std::right << std::fixed << std::setprecision(3) << std::setw(15) << step.insertedBootstrapMs
+                << "    (inserted)" << std::endl;
+    }
+    std::cout << std::left << std::setw(5) << s + 1
+              << std::left << std::setw(12) << step.step.op
+              << std::right << std::setw(7) << step.step.count
+              << std::right << std::setw(7) << step.level
+              << std::right << std::fixed << std::setprecision(3) << std::setw(15) << step.latencyMs
+              << std::right << std::fixed << std::setprecision(2) << std::setw(11) << step.workingSetBytes / double(1 << 20);
+    if (validated) {
+      if (measured[s] >= 0) {
+        predictedValidated += step.latencyMs;
+        measuredTotal += measured[s];
+        std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(14) << measured[s]
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(9) << 100 * (step.latencyMs - measured[s]) / measured[s] << "%";
+      }
+      else {
+        std::cout << std::right << std::setw(14) << "-" << std::right << std::setw(10) << "-";
+      }
+    }
+    std::cout << std::endl;
+  }
+  std::cout << std::string(width, '-') << std::endl;
+  std::cout << "Predicted latency: " << std::fixed << std::setprecision(3) << prediction.totalMs << " ms" << std::endl;
+  std::cout << "Bootstraps: " << prediction.bootstraps << " (" << prediction.insertedBootstraps << " inserted where the depth ran out)" << std::endl;
+  std::cout << "Largest per-step working set: " << std::setprecision(2) << prediction.maxWorkingSetBytes / double(1 << 20)
+            << " MB (input and outputs of one step; ciphertexts kept across steps are not counted)" << std::endl;
+  if (validated && measuredTotal > 0) {
+    std::cout << "Validated steps: predicted " << std::setprecision(3) << predictedValidated << " ms, measured " << measuredTotal
+              << " ms, error " << std::setprecision(1) << 100 * (predictedValidated - measuredTotal) / measuredTotal << "%" << std::endl;
+    std::cout << "Bootstraps and uncalibrated operations are predicted only." << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  if (!args.has("calibration") || !args.has("circuit")) {
+    std::cerr << "Usage: " << argv[0] << " --calibration <results.csv>[,...] --circuit <circuit.txt> [--validate]" << std::endl;
+    return 2;
+  }
+
+  // bad input files or options end the run with a message, like the usage error
+  try {
+    Calibration calibration = readCalibration(args.getList("calibration", {}), args);
+    std::vector<CircuitStep> steps = readCircuit(args.get("circuit", ""));
+    std::cout << "Calibration: " << calibration.config.label() << ", " << calibration.latencies.size() << " operation(s)" << std::endl;
+
+    Prediction prediction = predict(calibration, steps, args.getUInt("levels-after-bootstrap", 3));
+    std::vector<double> measured;
+    if (args.has("validate")) {
+      measured = validate(calibration, prediction, args.getUInt("repeats", 5));
+    }
+    printPrediction(prediction, measured);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
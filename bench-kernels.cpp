@@ -0,0 +1,356 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Times composite kernels built from the primitives of bench-add-mul:
+// EvalSum and EvalInnerProduct reductions, diagonal-method matrix-vector
+// products, Chebyshev polynomial evaluation and one logistic-regression
+// inference step. Each kernel reports its latency, the number of levels it
+// consumes and the precision of the decrypted result.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+struct KernelRow {
+  std::string kernel;
+  uint32_t size;
+  double latencyMs;
+  int32_t depth;
+  double precisionBits;
+};
+
+// Levels consumed so far, counting a pending (not yet rescaled) multiplication.
+static int32_t levelsConsumed(const Ciphertext<DCRTPoly>& ciphertext)
+{
+  return static_cast<int32_t>(ciphertext->GetLevel() + ciphertext->GetNoiseScaleDeg()) - 1;
+}
+
+// -log2 of the largest error over every stride-th slot, relative to the largest
+// reference magnitude when that exceeds 1 (sums grow with the number of slots).
+static double precisionBits(const std::vector<double>& values, const std::vector<double>& expected, uint32_t stride)
+{
+  double maxError = 0;
+  double maxMagnitude = 1;
+  for (size_t i = 0; i < expected.size() && i < values.size(); i += stride) {
+    maxError = std::max(maxError, std::fabs(values[i] - expected[i]));
+    maxMagnitude = std::max(maxMagnitude, std::fabs(expected[i]));
+  }
+  return maxError > 0 ? -std::log2(maxError / maxMagnitude) : 0;
+}
+
+// Tiles block over all slots, so that rotations of the slots rotate every copy of block cyclically.
+static std::vector<double> replicate(const std::vector<double>& block, uint32_t slots)
+{
+  std::vector<double> result(slots);
+  for (uint32_t i = 0; i < slots; i++) {
+    result[i] = block[i % block.size()];
+  }
+  return result;
+}
+
+static double sigmoid(double x)
+{
+  return 1.0 / (1.0 + std::exp(-x));
+}
+
+// Baby-step giant-step split of a d x d diagonal product: d = babySteps * giantSteps.
+static uint32_t babySteps(uint32_t d)
+{
+  return 1u << ((static_cast<uint32_t>(std::log2(d)) + 1) / 2);
+}
+
+// Rotation indices needed by evalMatVec for dimension d.
+static std::vector<int32_t> matVecRotations(uint32_t d)
+{
+  std::vector<int32_t> indices;
+  uint32_t b = babySteps(d);
+  for (uint32_t i = 1; i < b; i++) {
+    indices.push_back(static_cast<int32_t>(i));
+  }
+  for (uint32_t j = b; j < d; j += b) {
+    indices.push_back(static_cast<int32_t>(j));
+  }
+  return indices;
+}
+
+// Encodes the generalized diagonals of a d x d row-major matrix for evalMatVec.
+// Diagonal k = j * babySteps + i is pre-rotated by -j * babySteps so that the
+// giant-step rotation can be applied once to the sum of each baby-step group.
+static std::vector<Plaintext> encodeDiagonals(const CryptoContext<DCRTPoly>& cc, const std::vector<double>& matrix,
+                                              uint32_t d, uint32_t slots)
+{
+  uint32_t b = babySteps(d);
+  std::vector<Plaintext> diagonals;
+  for (uint32_t k = 0; k < d; k++) {
+    uint32_t shift = (k / b) * b;
+    std::vector<double> diagonal(d);
+    for (uint32_t row = 0; row < d; row++) {
+      uint32_t r = (row + d - shift) % d;
+      diagonal[row] = matrix[r * d + (r + k) % d];
+    }
+    diagonals.push_back(cc->MakeCKKSPackedPlaintext(replicate(diagonal, slots)));
+  }
+  return diagonals;
+}
+
+// Halevi-Shoup diagonal method with baby-step giant-step rotations; the baby
+// steps share one hoisted precomputation. Consumes one level.
+static Ciphertext<DCRTPoly> evalMatVec(const CryptoContext<DCRTPoly>& cc, const Ciphertext<DCRTPoly>& vector,
+                                       const std::vector<Plaintext>& diagonals, uint32_t d)
+{
+  uint32_t b = babySteps(d);
+  uint32_t m = cc->GetCyclotomicOrder();
+  auto digits = cc->EvalFastRotationPrecompute(vector);
+  std::vector<Ciphertext<DCRTPoly>> rotated(b);
+  rotated[0] = vector;
+  for (uint32_t i = 1; i < b; i++) {
+    rotated[i] = cc->EvalFastRotation(vector, i, m, digits);
+  }
+
+  Ciphertext<DCRTPoly> result;
+  for (uint32_t j = 0; j < d; j += b) {
+    Ciphertext<DCRTPoly> group = cc->EvalMult(rotated[0], diagonals[j]);
+    for (uint32_t i = 1; i < b; i++) {
+      group = cc->EvalAdd(group, cc->EvalMult(rotated[i], diagonals[j + i]));
+    }
+    if (j > 0) {
+      group = cc->EvalRotate(group, static_cast<int32_t>(j));
+    }
+    result = result ? cc->EvalAdd(result, group) : group;
+  }
+  return result;
+}
+
+// One inference step for slots / features samples packed side by side:
+// sigmoid(<x, w> + bias), with the inner products summed by log2(features)
+// rotations. The score of sample s ends up in slot s * features.
+static Ciphertext<DCRTPoly> evalLogisticStep(const CryptoContext<DCRTPoly>& cc, const Ciphertext<DCRTPoly>& samples,
+                                             const Plaintext& weights, double bias, uint32_t features, uint32_t degree)
+{
+  Ciphertext<DCRTPoly> score = cc->EvalMult(samples, weights);
+  for (uint32_t step = 1; step < features; step *= 2) {
+    score = cc->EvalAdd(score, cc->EvalRotate(score, static_cast<int32_t>(step)));
+  }
+  return cc->EvalLogistic(cc->EvalAdd(score, bias), -8, 8, degree);
+}
+
+struct KernelInputs {
+  std::vector<uint32_t> matVecDims;
+  std::vector<uint32_t> degrees;
+  uint32_t features;
+  uint32_t logisticDegree;
+};
+
+static std::vector<KernelRow> runKernels(const CKKSConfig& config, const KernelInputs& params, const ProfileOptions& options,
+                                         std::vector<ProfileData>& profiles)
+{
+  uint32_t slots = config.batchSize;
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  cc->Enable(ADVANCEDSHE);
+
+  std::set<int32_t> rotations;
+  for (uint32_t d : params.matVecDims) {
+    if (d > slots || slots % d != 0) {
+      throw std::invalid_argument("Matrix dimension " + std::to_string(d) + " must divide the batch size");
+    }
+    for (int32_t index : matVecRotations(d)) {
+      rotations.insert(index);
+    }
+  }
+  if (params.features > slots || slots % params.features != 0) {
+    throw std::invalid_argument("Feature count " + std::to_string(params.features) + " must divide the batch size");
+  }
+  for (uint32_t step = 1; step < params.features; step *= 2) {
+    rotations.insert(static_cast<int32_t>(step));
+  }
+
+  KeyPair<DCRTPoly> keys = cc->KeyGen();
+  cc->EvalMultKeyGen(keys.secretKey);
+  cc->EvalSumKeyGen(keys.secretKey);
+  cc->EvalRotateKeyGen(keys.secretKey, std::vector<int32_t>(rotations.begin(), rotations.end()));
+  OpInputs inputs = makeOpInputs(cc, keys, slots, 42);
+  int32_t freshLevels = levelsConsumed(inputs.c1);
+
+  std::vector<KernelRow> rows;
+  auto profileKernel = [&](const std::string& kernel, uint32_t size, const std::vector<double>& expected, uint32_t stride,
+                           const std::function<Ciphertext<DCRTPoly>()>& run) {
+    profiles.push_back(measureOperation(kernel + " (" + std::to_string(size) + ")", options, run));
+    Ciphertext<DCRTPoly> output = run();
+    profiles.back().outputBytes = serializedSize(output);
+
+    Plaintext result;
+    cc->Decrypt(keys.secretKey, output, &result);
+    result->SetLength(slots);
+    rows.push_back({kernel, size, profiles.back().stats.median, levelsConsumed(output) - freshLevels,
+                    precisionBits(result->GetRealPackedValue(), expected, stride)});
+  };
+
+  // reductions over all slots
+  double sum = std::accumulate(inputs.x1.begin(), inputs.x1.end(), 0.0);
+  double dot = std::inner_product(inputs.x1.begin(), inputs.x1.end(), inputs.x2.begin(), 0.0);
+  profileKernel("EvalSum", slots, std::vector<double>(slots, sum), 1, [&] { return cc->EvalSum(inputs.c1, slots); });
+  profileKernel("EvalInnerProduct", slots, std::vector<double>(slots, dot), 1,
+                [&] { return cc->EvalInnerProduct(inputs.c1, inputs.c2, slots); });
+
+  // matrix-vector products with entries of the same range as the inputs
+  for (uint32_t d : params.matVecDims) {
+    std::vector<double> matrix = generateRandomDoubleVector(size_t(d) * d, d);
+    std::vector<double> expected(d, 0);
+    for (uint32_t row = 0; row < d; row++) {
+      for (uint32_t col = 0; col < d; col++) {
+        expected[row] += matrix[row * d + col] * inputs.x1[col];
+      }
+    }
+    std::vector<double> vector(inputs.x1.begin(), inputs.x1.begin() + d);
+    Ciphertext<DCRTPoly> encrypted = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(replicate(vector, slots)));
+    std::vector<Plaintext> diagonals = encodeDiagonals(cc, matrix, d, slots);
+    profileKernel("MatVec", d, replicate(expected, slots), 1, [&] { return evalMatVec(cc, encrypted, diagonals, d); });
+  }
+
+  // polynomial evaluation on [-8, 8]; the inputs lie in [0.1, 5]
+  auto function = [](double x) { return std::sin(x); };
+  for (uint32_t degree : params.degrees) {
+    std::vector<double> sines(slots), sigmoids(slots);
+    std::transform(inputs.x1.begin(), inputs.x1.end(), sines.begin(), function);
+    std::transform(inputs.x1.begin(), inputs.x1.end(), sigmoids.begin(), sigmoid);
+    profileKernel("EvalChebyshev (sin)", degree, sines, 1,
+                  [&] { return cc->EvalChebyshevFunction(function, inputs.c1, -8, 8, degree); });
+    profileKernel("EvalLogistic", degree, sigmoids, 1, [&] { return cc->EvalLogistic(inputs.c1, -8, 8, degree); });
+  }
+
+  // weights are bounded by 1.5 / features, so every score stays inside [-8, 8]
+  uint32_t features = params.features;
+  std::vector<double> weights = generateRandomDoubleVector(features, 7);
+  for (auto& w : weights) {
+    w = (w - 2.55) / 2.45 * 1.5 / features;
+  }
+  double bias = 0.25;
+  std::vector<double> scores(slots, 0);
+  for (uint32_t sample = 0; sample < slots / features; sample++) {
+    double z = bias;
+    for (uint32_t f = 0; f < features; f++) {
+      z += inputs.x1[sample * features + f] * weights[f];
+    }
+    scores[sample * features] = sigmoid(z);
+  }
+  Plaintext weightsPtxt = cc->MakeCKKSPackedPlaintext(replicate(weights, slots));
+  profileKernel("LogReg step", features, scores, features,
+                [&] { return evalLogisticStep(cc, inputs.c1, weightsPtxt, bias, features, params.logisticDegree); });
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  cc->ClearEvalSumKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return rows;
+}
+
+static void printKernelResults(const std::vector<KernelRow>& rows)
+{
+  std::cout << "\n============ Kernel Results ============\n";
+  std::cout << std::left << std::setw(22) << "Kernel"
+            << std::right << std::setw(10) << "Size"
+            << std::right << std::setw(14) << "Median (ms)"
+            << std::right << std::setw(8) << "Depth"
+            << std::right << std::setw(16) << "Precision (bits)" << std::endl;
+  std::cout << std::string(70, '-') << std::endl;
+
+  for (const auto& row : rows) {
+    std::cout << std::left << std::setw(22) << row.kernel
+              << std::right << std::setw(10) << row.size
+              << std::right << std::fixed << std::setprecision(3) << std::setw(14) << row.latencyMs
+              << std::right << std::setw(8) << row.depth
+              << std::right << std::fixed << std::setprecision(1) << std::setw(16) << row.precisionBits << std::endl;
+  }
+  std::cout << std::string(70, '-') << std::endl;
+  std::cout << "Size is the slot count for reductions, the dimension for MatVec, the degree for polynomials and the feature count for LogReg." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.maxRuns = 10;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  KernelInputs params;
+  params.matVecDims = args.getUIntList("matvec-dims", {16, 64, 256});
+  params.degrees = args.getUIntList("degrees", {5, 13, 27, 59, 119});
+  params.features = args.getUInt("features", 64);
+  params.logisticDegree = args.getUInt("logistic-degree", 27);
+  // the baby-step giant-step split and the rotate-and-add reduction need powers of two;
+  // whether they divide the batch size is checked per configuration
+  auto isPowerOfTwo = [](uint32_t n) { return n != 0 && (n & (n - 1)) == 0; };
+  for (uint32_t d : params.matVecDims) {
+    if (!isPowerOfTwo(d)) {
+      throw std::invalid_argument("--matvec-dims must be powers of two, got " + std::to_string(d));
+    }
+  }
+  if (!isPowerOfTwo(params.features)) {
+    throw std::invalid_argument("--features must be a power of two, got " + std::to_string(params.features));
+  }
+
+  printThreadingInfo();
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<ProfileData> profiles;
+      std::vector<KernelRow> rows = runKernels(config, params, options, profiles);
+      printKernelResults(rows);
+      resultSets.push_back({config.parameters(), profiles});
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-kernels", resultSets);
+
+  return 0;
+}
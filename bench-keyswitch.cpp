@@ -0,0 +1,184 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+// Compares key-switching techniques: EvalMult, Relinearize and EvalRotate
+// under BV and under HYBRID with a sweep of the number of digits (dnum),
+// together with key generation time and evaluation key sizes.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+struct KeySwitchRow {
+  CKKSConfig config;
+  // KeyGen, EvalMultKeyGen and EvalRotateKeyGen; outputBytes holds the size of the generated keys
+  std::vector<ProfileData> keyGenProfiles;
+  std::vector<ProfileData> profiles;
+};
+
+static KeySwitchRow runKeySwitch(const CKKSConfig& config, const ProfileOptions& options)
+{
+  KeySwitchRow row;
+  row.config = config;
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+
+  // key generation is timed once per step; repeating it only overwrites the stored keys
+  ProfileOptions keyGenOptions;
+  keyGenOptions.warmupRuns = 0;
+  keyGenOptions.minRuns = 1;
+  keyGenOptions.maxRuns = 1;
+
+  KeyPair<DCRTPoly> keys;
+  row.keyGenProfiles.push_back(measureOperation("KeyGen", keyGenOptions, [&] { keys = cc->KeyGen(); }));
+  row.keyGenProfiles.back().outputBytes = serializedSize(keys.publicKey);
+  row.keyGenProfiles.push_back(measureOperation("EvalMultKeyGen", keyGenOptions, [&] { cc->EvalMultKeyGen(keys.secretKey); }));
+  row.keyGenProfiles.back().outputBytes = serializedEvalMultKeySize();
+  row.keyGenProfiles.push_back(measureOperation("EvalRotateKeyGen", keyGenOptions, [&] { cc->EvalRotateKeyGen(keys.secretKey, {1}); }));
+  row.keyGenProfiles.back().outputBytes = serializedEvalAutomorphismKeySize();
+
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+  for (const auto& op : makeAddMulOps(cc, keys)) {
+    if (op.name == "EvalMult (ciphertext)" || op.name == "Relinearize" || op.name == "EvalRotate (1)") {
+      row.profiles.push_back(profileOp(op, inputs, options));
+    }
+  }
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return row;
+}
+
+static void printKeySwitchResults(const std::vector<KeySwitchRow>& rows)
+{
+  std::cout << "\n============ Key Switching Comparison ============\n";
+  std::cout << std::left << std::setw(8) << "logN"
+            << std::right << std::setw(7) << "depth"
+            << std::right << std::setw(8) << "KS"
+            << std::right << std::setw(6) << "dnum"
+            << std::right << std::setw(13) << "KeyGen (ms)"
+            << std::right << std::setw(16) << "MultKeyGen (ms)"
+            << std::right << std::setw(15) << "RotKeyGen (ms)"
+            << std::right << std::setw(14) << "RelinKey (MB)"
+            << std::right << std::setw(13) << "RotKey (MB)"
+            << std::right << std::setw(14) << "EvalMult (ms)"
+            << std::right << std::setw(13) << "Relin (ms)"
+            << std::right << std::setw(13) << "Rotate (ms)" << std::endl;
+  std::cout << std::string(146, '-') << std::endl;
+
+  for (const auto& row : rows) {
+    const CKKSConfig& config = row.config;
+    std::cout << std::left << std::setw(8) << static_cast<uint32_t>(std::log2(config.ringDim))
+              << std::right << std::setw(7) << config.multDepth
+              << std::right << std::setw(8) << (config.keySwitchTechnique == BV ? "BV" : "HYBRID")
+              << std::right << std::setw(6) << (config.keySwitchTechnique == BV ? std::string("-") : std::to_string(config.numLargeDigits))
+              << std::right << std::fixed << std::setprecision(3) << std::setw(13) << row.keyGenProfiles[0].stats.median
+              << std::right << std::fixed << std::setprecision(3) << std::setw(16) << row.keyGenProfiles[1].stats.median
+              << std::right << std::fixed << std::setprecision(3) << std::setw(15) << row.keyGenProfiles[2].stats.median
+              << std::right << std::fixed << std::setprecision(3) << std::setw(14) << row.keyGenProfiles[1].outputBytes / double(1 << 20)
+              << std::right << std::fixed << std::setprecision(3) << std::setw(13) << row.keyGenProfiles[2].outputBytes / double(1 << 20);
+    for (const auto& profile : row.profiles) {
+      std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(13) << profile.stats.median;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << std::string(146, '-') << std::endl;
+  std::cout << "Operation latencies are medians." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.maxRuns = 20;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  std::vector<std::string> techniques = args.getList("techniques", {"BV", "HYBRID"});
+  std::vector<uint32_t> dnums = args.getUIntList("dnum", {1, 2, 3, 4, 6, 11});
+
+  printThreadingInfo();
+
+  std::vector<KeySwitchRow> rows;
+  for (const auto& base : buildConfigGrid(args)) {
+    std::vector<CKKSConfig> configs;
+    for (const auto& technique : techniques) {
+      if (technique == "BV") {
+        CKKSConfig config = base;
+        config.keySwitchTechnique = BV;
+        configs.push_back(config);
+      }
+      else if (technique == "HYBRID") {
+        for (uint32_t dnum : dnums) {
+          CKKSConfig config = base;
+          config.keySwitchTechnique = HYBRID;
+          config.numLargeDigits = dnum;
+          configs.push_back(config);
+        }
+      }
+      else {
+        throw std::invalid_argument("Unknown key switching technique: " + technique);
+      }
+    }
+
+    for (const auto& config : configs) {
+      std::cout << "Running " << config.label() << std::endl;
+      try {
+        rows.push_back(runKeySwitch(config, options));
+      }
+      catch (const std::exception& e) {
+        std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+      }
+    }
+  }
+
+  printKeySwitchResults(rows);
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& row : rows) {
+    std::vector<ProfileData> profiles = row.keyGenProfiles;
+    profiles.insert(profiles.end(), row.profiles.begin(), row.profiles.end());
+    resultSets.push_back({row.config.parameters(), profiles});
+  }
+  writeResults(args, "bench-keyswitch", resultSets);
+
+  return 0;
+}
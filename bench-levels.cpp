@@ -0,0 +1,214 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Times the core homomorphic operations at every level of the modulus chain.
+// Fresh ciphertexts are brought to each level with LevelReduce (FIXEDMANUAL
+// scaling), so the table shows latency against the number of remaining RNS towers.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+struct LevelRow {
+  uint32_t level;
+  size_t towers;
+  // serialized size of an input ciphertext at this level
+  size_t ciphertextBytes;
+  std::vector<ProfileData> profiles;
+};
+
+static const std::vector<std::string> levelOpNames = {"EvalAdd", "EvalMult", "Relinearize", "Rescale", "EvalRotate", "Decrypt"};
+
+static std::vector<LevelRow> runLevels(const CKKSConfig& config, const std::vector<uint32_t>& levels, const ProfileOptions& options)
+{
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  KeyPair<DCRTPoly> keys = generateAddMulKeys(cc);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+
+  std::vector<LevelRow> rows;
+  for (uint32_t level : levels) {
+    if (level > config.multDepth) {
+      std::cout << "Skipping level " << level << " beyond depth " << config.multDepth << std::endl;
+      continue;
+    }
+    Ciphertext<DCRTPoly> c1 = level > 0 ? cc->LevelReduce(inputs.c1, nullptr, level) : inputs.c1;
+    Ciphertext<DCRTPoly> c2 = level > 0 ? cc->LevelReduce(inputs.c2, nullptr, level) : inputs.c2;
+    Ciphertext<DCRTPoly> product = cc->EvalMult(c1, c2);
+    Ciphertext<DCRTPoly> productNoRelin = cc->EvalMultNoRelin(c1, c2);
+
+    LevelRow row;
+    row.level = level;
+    row.towers = c1->GetElements()[0].GetNumOfElements();
+    row.ciphertextBytes = serializedSize(c1);
+    // every profile records the size of its own result; Decrypt yields no ciphertext
+    row.profiles.push_back(measureOperation("EvalAdd", options, [&] { return cc->EvalAdd(c1, c2); }));
+    row.profiles.back().outputBytes = serializedSize(cc->EvalAdd(c1, c2));
+    row.profiles.push_back(measureOperation("EvalMult", options, [&] { return cc->EvalMult(c1, c2); }));
+    row.profiles.back().outputBytes = serializedSize(product);
+    row.profiles.push_back(measureOperation("Relinearize", options, [&] { return cc->Relinearize(productNoRelin); }));
+    row.profiles.back().outputBytes = serializedSize(cc->Relinearize(productNoRelin));
+    // the last level has no tower left to drop
+    if (level < config.multDepth) {
+      row.profiles.push_back(measureOperation("Rescale", options, [&] { return cc->Rescale(product); }));
+      row.profiles.back().outputBytes = serializedSize(cc->Rescale(product));
+    }
+    row.profiles.push_back(measureOperation("EvalRotate", options, [&] { return cc->EvalRotate(c1, 1); }));
+    row.profiles.back().outputBytes = serializedSize(cc->EvalRotate(c1, 1));
+    row.profiles.push_back(measureOperation("Decrypt", options, [&] {
+      Plaintext result;
+      cc->Decrypt(keys.secretKey, c1, &result);
+    }));
+    rows.push_back(row);
+  }
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return rows;
+}
+
+// Least-squares fit of median latency = fixed + perTower * towers.
+static std::pair<double, double> fitPerTower(const std::vector<LevelRow>& rows, const std::string& opName)
+{
+  double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (const auto& row : rows) {
+    for (const auto& profile : row.profiles) {
+      if (profile.operationName == opName) {
+        double x = static_cast<double>(row.towers);
+        double y = profile.stats.median;
+        n += 1;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+      }
+    }
+  }
+  double denominator = n * sxx - sx * sx;
+  if (n < 2 || denominator == 0) {
+    return {0, 0};
+  }
+  double perTower = (n * sxy - sx * sy) / denominator;
+  return {(sy - perTower * sx) / n, perTower};
+}
+
+static void printLevelResults(const std::vector<LevelRow>& rows)
+{
+  std::cout << "\n============ Latency vs Level (median ms) ============\n";
+  std::cout << std::left << std::setw(8) << "Level"
+            << std::right << std::setw(8) << "Towers";
+  for (const auto& name : levelOpNames) {
+    std::cout << std::right << std::setw(14) << name;
+  }
+  std::cout << std::right << std::setw(14) << "Ctxt (KB)" << std::endl;
+  std::cout << std::string(16 + 14 * (levelOpNames.size() + 1), '-') << std::endl;
+
+  for (const auto& row : rows) {
+    std::map<std::string, double> medians;
+    for (const auto& profile : row.profiles) {
+      medians[profile.operationName] = profile.stats.median;
+    }
+    std::cout << std::left << std::setw(8) << row.level
+              << std::right << std::setw(8) << row.towers;
+    for (const auto& name : levelOpNames) {
+      if (medians.count(name)) {
+        std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(14) << medians[name];
+      }
+      else {
+        std::cout << std::right << std::setw(14) << "-";
+      }
+    }
+    std::cout << std::right << std::fixed << std::setprecision(1) << std::setw(14) << row.ciphertextBytes / 1024.0 << std::endl;
+  }
+  std::cout << std::string(16 + 14 * (levelOpNames.size() + 1), '-') << std::endl;
+
+  std::cout << std::left << std::setw(16) << "Fixed (ms)";
+  for (const auto& name : levelOpNames) {
+    std::cout << std::right << std::fixed << std::setprecision(4) << std::setw(14) << fitPerTower(rows, name).first;
+  }
+  std::cout << std::endl << std::left << std::setw(16) << "Per tower (ms)";
+  for (const auto& name : levelOpNames) {
+    std::cout << std::right << std::fixed << std::setprecision(4) << std::setw(14) << fitPerTower(rows, name).second;
+  }
+  std::cout << std::endl;
+  std::cout << "Fixed and per-tower costs are a least-squares fit of the medians against the tower count." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.maxRuns = 20;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  printThreadingInfo();
+
+  std::vector<ResultSet> resultSets;
+  for (CKKSConfig config : buildConfigGrid(args)) {
+    config.scalingTechnique = FIXEDMANUAL;
+    std::vector<uint32_t> allLevels;
+    for (uint32_t level = 0; level <= config.multDepth; level++) {
+      allLevels.push_back(level);
+    }
+    std::vector<uint32_t> levels = args.getUIntList("levels", allLevels);
+
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<LevelRow> rows = runLevels(config, levels, options);
+      printLevelResults(rows);
+      for (const auto& row : rows) {
+        ParameterList parameters = config.parameters();
+        parameters.push_back({"level", std::to_string(row.level)});
+        parameters.push_back({"towers", std::to_string(row.towers)});
+        resultSets.push_back({parameters, row.profiles});
+      }
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-levels", resultSets);
+
+  return 0;
+}
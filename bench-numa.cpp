@@ -0,0 +1,428 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Multi-instance scaling across NUMA nodes. Forks one benchmark instance per
+// NUMA node, per group of cores or per core (--layout), runs the same
+// operations in all of them at once and adds up their throughput. Every layout
+// is run under several placements: pinned with memory bound to the local node,
+// pinned with memory bound to another node, unpinned with memory interleaved
+// over all nodes, and unpinned with the default policy.
+//
+// Instances are forked before the launcher touches OpenFHE or OpenMP, and each
+// sets its placement before building its context, so all its keys and
+// ciphertexts are allocated under that placement. Each operation starts in all
+// instances at once, so one instance's tail never overlaps another's next op.
+//
+// The instances run the bench-add-mul operation set in-process; this is a
+// standalone launcher rather than a mode that wraps the other benchmark binaries.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "numa-topology.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+using Clock = std::chrono::steady_clock;
+
+// Where one instance runs: the CPUs it is pinned to (none: unpinned) and
+// how its memory is placed.
+struct Instance {
+  std::vector<uint32_t> cpus;
+  uint32_t threads = 1;
+  enum { DEFAULT, BIND, INTERLEAVE } memory = DEFAULT;
+  std::vector<uint32_t> memoryNodes;
+};
+
+struct OpResult {
+  std::vector<double> samples;
+  double elapsedMs = 0;
+};
+
+struct PlacementResult {
+  std::string placement;
+  uint32_t instances;
+  uint32_t threads;
+  std::vector<std::string> opNames;
+  std::vector<double> opsPerSecond;
+  std::vector<ProfileData> profiles;
+};
+
+static void writeAll(int fd, const void* data, size_t size)
+{
+  const char* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written < 0) {
+      throw std::runtime_error(std::string("write failed: ") + std::strerror(errno));
+    }
+    bytes += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+static void readAll(int fd, void* data, size_t size)
+{
+  char* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t received = read(fd, bytes, size);
+    if (received <= 0) {
+      throw std::runtime_error("Instance exited early");
+    }
+    bytes += received;
+    size -= static_cast<size_t>(received);
+  }
+}
+
+// CPU sets of the layout, each with the node it belongs to.
+static std::vector<std::pair<std::vector<uint32_t>, uint32_t>> layoutCpuSets(const std::vector<NumaNode>& nodes,
+                                                                             const std::string& layout, uint32_t groupSize)
+{
+  std::vector<std::pair<std::vector<uint32_t>, uint32_t>> sets;
+  for (const auto& node : nodes) {
+    if (layout == "node") {
+      sets.push_back({node.cpus, node.id});
+    }
+    else if (layout == "group" || layout == "core") {
+      uint32_t size = layout == "core" ? 1 : groupSize;
+      // a trailing group smaller than the others is left idle
+      for (size_t first = 0; first + size <= node.cpus.size(); first += size) {
+        sets.push_back({std::vector<uint32_t>(node.cpus.begin() + first, node.cpus.begin() + first + size), node.id});
+      }
+    }
+    else {
+      throw std::invalid_argument("Unknown layout: " + layout);
+    }
+  }
+  return sets;
+}
+
+static std::vector<Instance> placeInstances(const std::vector<NumaNode>& nodes, const std::string& layout,
+                                            uint32_t groupSize, const std::string& placement)
+{
+  std::vector<uint32_t> allNodes;
+  for (const auto& node : nodes) {
+    allNodes.push_back(node.id);
+  }
+
+  std::vector<Instance> instances;
+  for (const auto& set : layoutCpuSets(nodes, layout, groupSize)) {
+    Instance instance;
+    instance.threads = static_cast<uint32_t>(set.first.size());
+    if (placement == "local") {
+      instance.cpus = set.first;
+      instance.memory = Instance::BIND;
+      instance.memoryNodes = {set.second};
+    }
+    else if (placement == "remote") {
+      size_t index = std::find(allNodes.begin(), allNodes.end(), set.second) - allNodes.begin();
+      instance.cpus = set.first;
+      instance.memory = Instance::BIND;
+      instance.memoryNodes = {allNodes[(index + 1) % allNodes.size()]};
+    }
+    else if (placement == "interleaved") {
+      instance.memory = Instance::INTERLEAVE;
+      instance.memoryNodes = allNodes;
+    }
+    else if (placement != "unpinned") {
+      throw std::invalid_argument("Unknown placement: " + placement);
+    }
+    instances.push_back(instance);
+  }
+  return instances;
+}
+
+// Body of one instance process: applies the placement, sets up the context and
+// inputs, reports ready on fd, waits for the start signal, then runs every
+// operation jobs times and sends back the latencies.
+static void runInstance(int fd, const Instance& instance, const CKKSConfig& config, const std::vector<std::string>& opNames,
+                        uint32_t jobs, uint32_t seed)
+{
+  if (!instance.cpus.empty() && !pinProcessToCpus(instance.cpus)) {
+    throw std::runtime_error("sched_setaffinity failed");
+  }
+  if (instance.memory == Instance::BIND && !bindMemoryToNodes(instance.memoryNodes)) {
+    throw std::runtime_error("set_mempolicy(MPOL_BIND) failed");
+  }
+  if (instance.memory == Instance::INTERLEAVE && !interleaveMemoryOverNodes(instance.memoryNodes)) {
+    throw std::runtime_error("set_mempolicy(MPOL_INTERLEAVE) failed");
+  }
+  setIntraOpThreads(instance.threads);
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  auto keys = generateAddMulKeys(cc);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, seed);
+  std::vector<BenchOp> allOps = makeAddMulOps(cc, keys);
+  std::vector<BenchOp> ops;
+  for (const auto& name : opNames) {
+    auto it = std::find_if(allOps.begin(), allOps.end(), [&name](const BenchOp& op) { return op.name == name; });
+    if (it == allOps.end()) {
+      throw std::invalid_argument("Unknown operation: " + name);
+    }
+    ops.push_back(*it);
+  }
+  // one untimed run so that lazily built tables are not charged to the first job
+  for (const auto& op : ops) {
+    op.run(inputs);
+  }
+
+  for (const auto& op : ops) {
+    // barrier per operation: no instance starts before all have finished the previous one
+    char signal = 'r';
+    writeAll(fd, &signal, 1);
+    readAll(fd, &signal, 1);
+
+    std::vector<double> samples;
+    auto start = Clock::now();
+    for (uint32_t j = 0; j < jobs; j++) {
+      auto jobStart = Clock::now();
+      op.run(inputs);
+      samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - jobStart).count());
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    writeAll(fd, &elapsedMs, sizeof(elapsedMs));
+    writeAll(fd, samples.data(), samples.size() * sizeof(double));
+  }
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+}
+
+// Forks every instance, starts each operation in all of them together once all
+// are ready for it and aggregates their throughput per operation.
+static PlacementResult runPlacement(const std::string& placement, const std::vector<Instance>& instances,
+                                    const CKKSConfig& config, const std::vector<std::string>& opNames, uint32_t jobs)
+{
+  std::vector<pid_t> pids;
+  std::vector<int> fds;
+  for (size_t i = 0; i < instances.size(); i++) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0) {
+      throw std::runtime_error(std::string("socketpair failed: ") + std::strerror(errno));
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+      throw std::runtime_error(std::string("fork failed: ") + std::strerror(errno));
+    }
+    if (pid == 0) {
+      close(pair[0]);
+      int status = 0;
+      try {
+        runInstance(pair[1], instances[i], config, opNames, jobs, 42 + static_cast<uint32_t>(i));
+      }
+      catch (const std::exception& e) {
+        std::cerr << "instance " << i << ": " << e.what() << std::endl;
+        status = 1;
+      }
+      _exit(status);
+    }
+    close(pair[1]);
+    pids.push_back(pid);
+    fds.push_back(pair[0]);
+  }
+
+  PlacementResult result;
+  result.placement = placement;
+  result.instances = static_cast<uint32_t>(instances.size());
+  result.threads = instances.empty() ? 0 : instances.front().threads;
+  result.opNames = opNames;
+  std::vector<std::vector<OpResult>> perInstance(instances.size(), std::vector<OpResult>(opNames.size()));
+  try {
+    for (size_t k = 0; k < opNames.size(); k++) {
+      char signal;
+      for (int fd : fds) {
+        readAll(fd, &signal, 1);
+      }
+      for (int fd : fds) {
+        writeAll(fd, &signal, 1);
+      }
+      for (size_t i = 0; i < fds.size(); i++) {
+        OpResult& op = perInstance[i][k];
+        op.samples.resize(jobs);
+        readAll(fds[i], &op.elapsedMs, sizeof(op.elapsedMs));
+        readAll(fds[i], op.samples.data(), jobs * sizeof(double));
+      }
+    }
+  }
+  catch (const std::exception&) {
+    for (pid_t pid : pids) {
+      kill(pid, SIGTERM);
+      waitpid(pid, nullptr, 0);
+    }
+    for (int fd : fds) {
+      close(fd);
+    }
+    throw;
+  }
+  // an instance can still fail after sending its results, e.g. while releasing its context
+  bool failed = false;
+  for (size_t i = 0; i < pids.size(); i++) {
+    int status = 0;
+    waitpid(pids[i], &status, 0);
+    close(fds[i]);
+    failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+  }
+  if (failed) {
+    throw std::runtime_error("Instance process failed");
+  }
+
+  for (size_t k = 0; k < opNames.size(); k++) {
+    double opsPerSecond = 0;
+    std::vector<double> samples;
+    for (const auto& ops : perInstance) {
+      opsPerSecond += jobs / (ops[k].elapsedMs / 1000);
+      samples.insert(samples.end(), ops[k].samples.begin(), ops[k].samples.end());
+    }
+    ProfileData profile;
+    profile.operationName = opNames[k];
+    profile.stats = computeRunStats(samples, ProfileOptions().outlierThreshold);
+    profile.avgTimeExcludingFirst = profile.stats.mean;
+    profile.firstRunTime = samples.empty() ? 0 : samples.front();
+    profile.opsPerSecond = opsPerSecond;
+    result.opsPerSecond.push_back(opsPerSecond);
+    result.profiles.push_back(profile);
+  }
+  return result;
+}
+
+static void printNumaResults(const std::vector<PlacementResult>& results)
+{
+  std::cout << "\n============ Aggregate Throughput by Placement ============\n";
+  std::cout << std::left << std::setw(13) << "Placement"
+            << std::left << std::setw(25) << "Operation"
+            << std::right << std::setw(11) << "Instances"
+            << std::right << std::setw(9) << "Threads"
+            << std::right << std::setw(12) << "Ops/sec"
+            << std::right << std::setw(13) << "Median (ms)"
+            << std::right << std::setw(10) << "P99 (ms)"
+            << std::right << std::setw(14) << "vs unpinned" << std::endl;
+  std::cout << std::string(107, '-') << std::endl;
+
+  std::map<std::string, double> unpinned;
+  for (const auto& result : results) {
+    if (result.placement == "unpinned") {
+      for (size_t k = 0; k < result.opNames.size(); k++) {
+        unpinned[result.opNames[k]] = result.opsPerSecond[k];
+      }
+    }
+  }
+  for (const auto& result : results) {
+    for (size_t k = 0; k < result.opNames.size(); k++) {
+      std::cout << std::left << std::setw(13) << result.placement
+                << std::left << std::setw(25) << result.opNames[k]
+                << std::right << std::setw(11) << result.instances
+                << std::right << std::setw(9) << result.threads
+                << std::right << std::fixed << std::setprecision(2) << std::setw(12) << result.opsPerSecond[k]
+                << std::right << std::fixed << std::setprecision(3) << std::setw(13) << result.profiles[k].stats.median
+                << std::right << std::fixed << std::setprecision(3) << std::setw(10) << result.profiles[k].stats.p99;
+      if (unpinned.count(result.opNames[k]) > 0) {
+        std::cout << std::right << std::fixed << std::setprecision(2) << std::setw(13) << result.opsPerSecond[k] / unpinned[result.opNames[k]] << "x";
+      }
+      std::cout << std::endl;
+    }
+  }
+  std::cout << std::string(107, '-') << std::endl;
+  std::cout << "Ops/sec is summed over the instances; latencies are pooled over all instances." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  std::string layout = args.get("layout", "node");
+  uint32_t groupSize = args.getUInt("group-size", 4);
+  uint32_t jobs = args.getUInt("jobs", 32);
+  std::vector<std::string> opNames = args.getList("ops", {"EvalMult (ciphertext)", "EvalRotate (1)"});
+
+  std::vector<NumaNode> nodes = readNumaTopology();
+  std::vector<std::string> defaultPlacements = {"unpinned", "interleaved", "local"};
+  if (nodes.size() > 1) {
+    defaultPlacements.push_back("remote");
+  }
+  std::vector<std::string> placements = args.getList("placements", defaultPlacements);
+
+  std::cout << "NUMA nodes: " << nodes.size() << std::endl;
+  for (const auto& node : nodes) {
+    std::cout << "  node " << node.id << ": " << node.cpus.size() << " CPUs" << std::endl;
+  }
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<PlacementResult> results;
+      for (const auto& placement : placements) {
+        std::vector<Instance> instances = placeInstances(nodes, layout, groupSize, placement);
+        if (instances.empty()) {
+          throw std::invalid_argument("Layout " + layout + " leaves no CPU set to run on");
+        }
+        std::cout << "Running " << instances.size() << " " << placement << " instance(s), layout " << layout << std::endl;
+        results.push_back(runPlacement(placement, instances, config, opNames, jobs));
+      }
+      printNumaResults(results);
+      for (const auto& result : results) {
+        ParameterList parameters = config.parameters();
+        parameters.push_back({"layout", layout});
+        parameters.push_back({"placement", result.placement});
+        parameters.push_back({"instances", std::to_string(result.instances)});
+        parameters.push_back({"threads_per_instance", std::to_string(result.threads)});
+        resultSets.push_back({parameters, result.profiles});
+      }
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-numa", resultSets);
+
+  return 0;
+}
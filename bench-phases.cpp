@@ -0,0 +1,203 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Breaks EvalMult (ciphertext) and EvalRotate down into the DCRTPoly-level
+// phases they are built from: number-theoretic transforms (SwitchFormat),
+// element-wise modular multiplication, the key-switching ModUp (digit
+// decomposition and basis extension), the inner product with the evaluation key
+// and the ModDown back to the ciphertext modulus.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+struct PhaseShare {
+  std::string phase;
+  double ms;
+};
+
+static double median(const std::vector<ProfileData>& profiles, const std::string& name)
+{
+  for (const auto& profile : profiles) {
+    if (profile.operationName == name) {
+      return profile.stats.median;
+    }
+  }
+  return 0;
+}
+
+static std::vector<ProfileData> runPhases(const CKKSConfig& config, const ProfileOptions& options)
+{
+  std::vector<ProfileData> profiles;
+  if (config.keySwitchTechnique != HYBRID) {
+    throw std::invalid_argument("The phase breakdown follows HYBRID key switching");
+  }
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  KeyPair<DCRTPoly> keys = generateAddMulKeys(cc);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+
+  const DCRTPoly& a = inputs.c1->GetElements()[1];
+  const DCRTPoly& b2 = inputs.c2->GetElements()[0];
+  size_t towers = a.GetNumOfElements();
+  std::cout << "Ciphertext towers: " << towers << ", ring dimension " << cc->GetRingDimension() << std::endl;
+
+  // SwitchFormat toggles between evaluation and coefficient form, so one run is an
+  // inverse plus a forward transform and leaves the polynomial as it was
+  NativePoly tower = a.GetElementAtIndex(0);
+  profiles.push_back(measureOperation("NTT+INTT (1 tower)", options, [&] {
+    tower.SwitchFormat();
+    tower.SwitchFormat();
+  }));
+  DCRTPoly poly = a;
+  profiles.push_back(measureOperation("NTT+INTT (all towers)", options, [&] {
+    poly.SwitchFormat();
+    poly.SwitchFormat();
+  }));
+
+  const NativePoly& tower2 = b2.GetElementAtIndex(0);
+  profiles.push_back(measureOperation("Mod mult (1 tower)", options, [&] { return tower * tower2; }));
+  profiles.push_back(measureOperation("Mod mult (all towers)", options, [&] { return a * b2; }));
+
+  // key switching on the second ciphertext element, as in Relinearize and EvalRotate
+  auto scheme = cc->GetScheme();
+  auto cryptoParams = cc->GetCryptoParameters();
+  profiles.push_back(measureOperation("ModUp", options, [&] { return scheme->EvalKeySwitchPrecomputeCore(a, cryptoParams); }));
+
+  auto digits = scheme->EvalKeySwitchPrecomputeCore(a, cryptoParams);
+  EvalKey<DCRTPoly> relinKey = cc->GetEvalMultKeyVector(keys.secretKey->GetKeyTag())[0];
+  profiles.push_back(measureOperation("Key inner product+ModDown", options,
+                                      [&] { return scheme->EvalFastKeySwitchCore(digits, relinKey, a.GetParams()); }));
+
+  Ciphertext<DCRTPoly> extended = cc->KeySwitchExt(inputs.c1, true);
+  profiles.push_back(measureOperation("ModDown", options, [&] { return cc->KeySwitchDown(extended); }));
+
+  // the composite operations being attributed
+  profiles.push_back(measureOperation("EvalMultNoRelin", options, [&] { return cc->EvalMultNoRelin(inputs.c1, inputs.c2); }));
+  profiles.push_back(measureOperation("EvalMult (ciphertext)", options, [&] { return cc->EvalMult(inputs.c1, inputs.c2); }));
+  profiles.push_back(measureOperation("EvalRotate (1)", options, [&] { return cc->EvalRotate(inputs.c1, 1); }));
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return profiles;
+}
+
+// Splits the total into the given phases plus whatever they do not explain.
+static void printAttribution(const std::string& operation, double total, const std::vector<PhaseShare>& phases, double towerTransformMs)
+{
+  std::cout << "\n" << operation << ": " << std::fixed << std::setprecision(3) << total << " ms\n";
+  std::cout << std::left << std::setw(30) << "Phase"
+            << std::right << std::setw(12) << "ms"
+            << std::right << std::setw(10) << "Share"
+            << std::right << std::setw(18) << "Tower NTTs eq." << std::endl;
+  std::cout << std::string(70, '-') << std::endl;
+  double explained = 0;
+  std::vector<PhaseShare> rows = phases;
+  for (const auto& phase : phases) {
+    explained += phase.ms;
+  }
+  rows.push_back({"Other (adds, automorphism, ...)", total - explained});
+  for (const auto& row : rows) {
+    std::cout << std::left << std::setw(30) << row.phase
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << row.ms
+              << std::right << std::fixed << std::setprecision(1) << std::setw(9) << (total > 0 ? 100 * row.ms / total : 0) << "%"
+              << std::right << std::fixed << std::setprecision(1) << std::setw(18) << (towerTransformMs > 0 ? row.ms / towerTransformMs : 0) << std::endl;
+  }
+  std::cout << std::string(70, '-') << std::endl;
+}
+
+static void printPhaseResults(const std::vector<ProfileData>& profiles)
+{
+  double transform = median(profiles, "NTT+INTT (1 tower)") / 2;
+  double modUp = median(profiles, "ModUp");
+  double core = median(profiles, "Key inner product+ModDown");
+  double modDown = median(profiles, "ModDown");
+  double innerProduct = std::max(0.0, core - modDown);
+
+  std::cout << "\n============ Phase Attribution (medians) ============\n";
+  std::cout << "One tower NTT (or INTT): " << std::fixed << std::setprecision(4) << transform << " ms, "
+            << "all towers: " << median(profiles, "NTT+INTT (all towers)") / 2 << " ms" << std::endl;
+
+  printAttribution("EvalMult (ciphertext)", median(profiles, "EvalMult (ciphertext)"),
+                   {{"Tensor product", median(profiles, "EvalMultNoRelin")},
+                    {"ModUp (decompose + extend)", modUp},
+                    {"Key inner product", innerProduct},
+                    {"ModDown", modDown}},
+                   transform);
+  printAttribution("EvalRotate (1)", median(profiles, "EvalRotate (1)"),
+                   {{"ModUp (decompose + extend)", modUp},
+                    {"Key inner product", innerProduct},
+                    {"ModDown", modDown}},
+                   transform);
+  std::cout << "Tower NTTs eq. expresses each phase in single-tower transforms; ModUp and ModDown are dominated by them." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.maxRuns = 20;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  printThreadingInfo();
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<ProfileData> profiles = runPhases(config, options);
+      printProfileResults(profiles);
+      printPhaseResults(profiles);
+      resultSets.push_back({config.parameters(), profiles});
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-phases", resultSets);
+
+  return 0;
+}
@@ -0,0 +1,433 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Streams requests through encode -> encrypt -> compute -> decrypt -> decode,
+// each stage served by its own worker threads and connected by bounded lock-free
+// queues. Reports sustained throughput against running the same stages serially,
+// per-stage utilization, queue depths and end-to-end latency percentiles.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "bounded-queue.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+using Clock = std::chrono::steady_clock;
+
+struct PipelineItem {
+  Clock::time_point created;
+  const std::vector<double>* input = nullptr;
+  Plaintext plaintext;
+  Ciphertext<DCRTPoly> ciphertext;
+  std::vector<double> output;
+};
+
+using ItemPtr = std::unique_ptr<PipelineItem>;
+using ItemQueue = BoundedQueue<ItemPtr>;
+
+struct Stage {
+  std::string name;
+  uint32_t workers;
+  std::function<void(PipelineItem&)> process;
+  // filled in by the workers
+  std::atomic<uint64_t> taken{0};
+  std::atomic<uint64_t> busyNs{0};
+  std::vector<double> serviceMs;
+  std::mutex serviceMutex;
+};
+
+// The compute stage applies --compute in order: "add" adds a constant ciphertext,
+// "mult" multiplies by it (with relinearization and rescaling), "square" squares,
+// "rotate" rotates by one slot.
+static std::function<void(PipelineItem&)> makeComputeStage(const CryptoContext<DCRTPoly>& cc, const Ciphertext<DCRTPoly>& constant,
+                                                           const std::vector<std::string>& steps)
+{
+  for (const auto& step : steps) {
+    if (step != "add" && step != "mult" && step != "square" && step != "rotate") {
+      throw std::invalid_argument("Unknown compute step: " + step);
+    }
+  }
+  return [cc, constant, steps](PipelineItem& item) {
+    for (const auto& step : steps) {
+      if (step == "add") {
+        item.ciphertext = cc->EvalAdd(item.ciphertext, constant);
+      }
+      else if (step == "mult") {
+        item.ciphertext = cc->EvalMult(item.ciphertext, constant);
+      }
+      else if (step == "square") {
+        item.ciphertext = cc->EvalSquare(item.ciphertext);
+      }
+      else {
+        item.ciphertext = cc->EvalRotate(item.ciphertext, 1);
+      }
+    }
+  };
+}
+
+static double elapsedMs(Clock::time_point start, Clock::time_point end)
+{
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Waiting on an empty or full queue: a few yields for short stalls, then short
+// sleeps so that idle workers leave the cores to the OpenMP teams of busy stages.
+static void backOff(uint32_t& attempts)
+{
+  if (attempts++ < 16) {
+    std::this_thread::yield();
+  }
+  else {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+}
+
+// First exception thrown by any worker; it stops the pipeline and is rethrown by the driver.
+struct PipelineFailure {
+  std::atomic<bool> stopped{false};
+  std::exception_ptr error;
+  std::mutex mutex;
+
+  void fail(std::exception_ptr e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) {
+      error = e;
+    }
+    stopped.store(true);
+  }
+};
+
+// Pops from in until every item of the stage is taken, processes it and pushes it to out
+// (or to the completed list for the last stage). Waiting on an empty or full queue counts as idle.
+static void runStageWorker(Stage& stage, ItemQueue& in, ItemQueue* out, uint64_t totalItems, uint32_t intraOpThreads,
+                           std::vector<ItemPtr>& completed, std::vector<double>& completedAtMs, std::mutex& completedMutex,
+                           Clock::time_point start, PipelineFailure& failure)
+{
+  setIntraOpThreads(intraOpThreads);
+  std::vector<double> serviceMs;
+  try {
+    uint32_t attempts = 0;
+    while (!failure.stopped.load() && stage.taken.load() < totalItems) {
+      ItemPtr item;
+      if (!in.tryPop(item)) {
+        backOff(attempts);
+        continue;
+      }
+      attempts = 0;
+      stage.taken.fetch_add(1);
+
+      auto begin = Clock::now();
+      stage.process(*item);
+      auto end = Clock::now();
+      stage.busyNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+      serviceMs.push_back(elapsedMs(begin, end));
+
+      if (out != nullptr) {
+        while (!out->tryPush(std::move(item)) && !failure.stopped.load()) {
+          backOff(attempts);
+        }
+        attempts = 0;
+      }
+      else {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        completedAtMs.push_back(elapsedMs(start, end));
+        completed.push_back(std::move(item));
+      }
+    }
+  }
+  catch (...) {
+    failure.fail(std::current_exception());
+  }
+  std::lock_guard<std::mutex> lock(stage.serviceMutex);
+  stage.serviceMs.insert(stage.serviceMs.end(), serviceMs.begin(), serviceMs.end());
+}
+
+struct QueueStats {
+  double meanDepth = 0;
+  size_t maxDepth = 0;
+};
+
+struct PipelineResult {
+  double pipelinedPerSec;
+  double serialPerSec;
+  double wallSeconds;
+  std::vector<double> utilization;
+  std::vector<QueueStats> queues;
+  std::vector<ProfileData> profiles;
+};
+
+static PipelineResult runPipeline(const CKKSConfig& config, const BenchArgs& args)
+{
+  uint32_t numItems = args.getUInt("items", 200);
+  uint32_t capacity = args.getUInt("queue-capacity", 4);
+  uint32_t intraOpThreads = args.getUInt("intra-op-threads", 1);
+  std::vector<uint32_t> workers = args.getUIntList("stage-workers", {1, 1, 1, 1, 1});
+  std::vector<std::string> steps = args.getList("compute", {"mult", "rotate", "add"});
+  if (workers.size() != 5) {
+    throw std::invalid_argument("--stage-workers needs one count per stage (encode, encrypt, compute, decrypt, decode)");
+  }
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  KeyPair<DCRTPoly> keys = cc->KeyGen();
+  cc->EvalMultKeyGen(keys.secretKey);
+  cc->EvalRotateKeyGen(keys.secretKey, {1});
+  uint32_t batchSize = config.batchSize;
+
+  // a small pool of inputs is cycled so that input generation stays out of the measurement
+  std::vector<std::vector<double>> inputs;
+  for (uint32_t i = 0; i < 16; i++) {
+    inputs.push_back(generateRandomDoubleVector(batchSize, 42 + i));
+  }
+  Ciphertext<DCRTPoly> constant = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(inputs[0]));
+
+  Stage stages[5];
+  stages[0].name = "Encode";
+  stages[0].process = [cc](PipelineItem& item) { item.plaintext = cc->MakeCKKSPackedPlaintext(*item.input); };
+  stages[1].name = "Encrypt";
+  stages[1].process = [cc, keys](PipelineItem& item) { item.ciphertext = cc->Encrypt(keys.publicKey, item.plaintext); };
+  stages[2].name = "Compute";
+  stages[2].process = makeComputeStage(cc, constant, steps);
+  // OpenFHE's Decrypt already decodes; the decode stage only extracts the real slot values
+  stages[3].name = "Decrypt";
+  stages[3].process = [cc, keys](PipelineItem& item) { cc->Decrypt(keys.secretKey, item.ciphertext, &item.plaintext); };
+  stages[4].name = "Decode";
+  stages[4].process = [batchSize](PipelineItem& item) {
+    item.plaintext->SetLength(batchSize);
+    item.output = item.plaintext->GetRealPackedValue();
+  };
+  for (size_t s = 0; s < 5; s++) {
+    stages[s].workers = std::max(1u, workers[s]);
+  }
+
+  PipelineResult result;
+
+  // serial reference: the same stages one item after another on this thread
+  {
+    setIntraOpThreads(intraOpThreads);
+    uint32_t serialItems = std::max(1u, numItems / 4);
+    auto begin = Clock::now();
+    for (uint32_t i = 0; i < serialItems; i++) {
+      PipelineItem item;
+      item.input = &inputs[i % inputs.size()];
+      for (auto& stage : stages) {
+        stage.process(item);
+      }
+    }
+    result.serialPerSec = serialItems / (elapsedMs(begin, Clock::now()) / 1000);
+  }
+
+  // queue 0 feeds the encoder; queue s sits between stage s - 1 and stage s
+  std::vector<std::unique_ptr<ItemQueue>> queues;
+  for (size_t s = 0; s < 5; s++) {
+    queues.push_back(std::make_unique<ItemQueue>(capacity));
+  }
+
+  std::vector<ItemPtr> completed;
+  std::vector<double> completedAtMs;
+  std::mutex completedMutex;
+  std::atomic<bool> running{true};
+  PipelineFailure failure;
+  std::vector<uint64_t> depthSums(5, 0);
+  std::vector<size_t> depthMax(5, 0);
+  uint64_t depthSamples = 0;
+
+  auto start = Clock::now();
+  std::vector<std::thread> threads;
+  for (size_t s = 0; s < 5; s++) {
+    ItemQueue* out = (s + 1 < 5) ? queues[s + 1].get() : nullptr;
+    for (uint32_t w = 0; w < stages[s].workers; w++) {
+      threads.emplace_back(runStageWorker, std::ref(stages[s]), std::ref(*queues[s]), out, uint64_t(numItems), intraOpThreads,
+                           std::ref(completed), std::ref(completedAtMs), std::ref(completedMutex), start,
+                           std::ref(failure));
+    }
+  }
+  std::thread sampler([&] {
+    while (running.load()) {
+      for (size_t s = 0; s < 5; s++) {
+        size_t depth = queues[s]->sizeApprox();
+        depthSums[s] += depth;
+        depthMax[s] = std::max(depthMax[s], depth);
+      }
+      depthSamples++;
+      std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+  });
+
+  // the source offers items as fast as the first queue accepts them
+  uint32_t attempts = 0;
+  for (uint32_t i = 0; i < numItems && !failure.stopped.load(); i++) {
+    auto item = std::make_unique<PipelineItem>();
+    item->input = &inputs[i % inputs.size()];
+    item->created = Clock::now();
+    while (!queues[0]->tryPush(std::move(item)) && !failure.stopped.load()) {
+      backOff(attempts);
+    }
+    attempts = 0;
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto end = Clock::now();
+  running.store(false);
+  sampler.join();
+  if (failure.error) {
+    std::rethrow_exception(failure.error);
+  }
+
+  result.wallSeconds = elapsedMs(start, end) / 1000;
+  for (size_t s = 0; s < 5; s++) {
+    result.utilization.push_back(stages[s].busyNs.load() / 1e9 / (result.wallSeconds * stages[s].workers));
+    result.queues.push_back({depthSamples ? double(depthSums[s]) / depthSamples : 0, depthMax[s]});
+  }
+
+  // the first 10% of completions fill the pipeline and are left out of throughput and latency
+  size_t skip = completed.size() / 10;
+  std::vector<double> latencies;
+  for (size_t i = skip; i < completed.size(); i++) {
+    latencies.push_back(completedAtMs[i] - elapsedMs(start, completed[i]->created));
+  }
+  // several decode workers may record their completions slightly out of order
+  std::vector<double> finished = completedAtMs;
+  std::sort(finished.begin(), finished.end());
+  std::vector<double> intervals;
+  for (size_t i = skip + 1; i < finished.size(); i++) {
+    intervals.push_back(finished[i] - finished[i - 1]);
+  }
+  double steadyMs = finished.empty() ? 0 : finished.back() - finished[skip];
+  result.pipelinedPerSec = steadyMs > 0 ? (finished.size() - 1 - skip) / (steadyMs / 1000) : 0;
+
+  ProfileOptions statsOptions;
+  for (auto& stage : stages) {
+    ProfileData profile;
+    profile.operationName = stage.name;
+    profile.stats = computeRunStats(stage.serviceMs, statsOptions.outlierThreshold);
+    profile.avgTimeExcludingFirst = profile.stats.mean;
+    result.profiles.push_back(profile);
+  }
+  ProfileData interval;
+  interval.operationName = "Completion interval";
+  interval.stats = computeRunStats(intervals, statsOptions.outlierThreshold);
+  interval.avgTimeExcludingFirst = interval.stats.mean;
+  result.profiles.push_back(interval);
+  ProfileData latency;
+  latency.operationName = "End-to-end latency";
+  latency.stats = computeRunStats(latencies, statsOptions.outlierThreshold);
+  latency.avgTimeExcludingFirst = latency.stats.mean;
+  result.profiles.push_back(latency);
+
+  std::cout << "Pipeline: " << numItems << " items, queue capacity " << queues[0]->capacity()
+            << ", compute = " << steps.size() << " step(s), " << intraOpThreads << " intra-op thread(s) per worker" << std::endl;
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return result;
+}
+
+static void printPipelineResults(const PipelineResult& result, const std::vector<uint32_t>& workers)
+{
+  static const char* stageNames[] = {"Encode", "Encrypt", "Compute", "Decrypt", "Decode"};
+  std::cout << "\n============ Pipeline Stages ============\n";
+  std::cout << std::left << std::setw(12) << "Stage"
+            << std::right << std::setw(9) << "Workers"
+            << std::right << std::setw(16) << "Service (ms)"
+            << std::right << std::setw(14) << "Utilization"
+            << std::right << std::setw(16) << "In-queue mean"
+            << std::right << std::setw(15) << "In-queue max" << std::endl;
+  std::cout << std::string(82, '-') << std::endl;
+  size_t bottleneck = 0;
+  for (size_t s = 0; s < 5; s++) {
+    if (result.utilization[s] > result.utilization[bottleneck]) {
+      bottleneck = s;
+    }
+    std::cout << std::left << std::setw(12) << stageNames[s]
+              << std::right << std::setw(9) << std::max(1u, workers[s])
+              << std::right << std::fixed << std::setprecision(3) << std::setw(16) << result.profiles[s].stats.median
+              << std::right << std::fixed << std::setprecision(1) << std::setw(13) << 100 * result.utilization[s] << "%"
+              << std::right << std::fixed << std::setprecision(2) << std::setw(16) << result.queues[s].meanDepth
+              << std::right << std::setw(15) << result.queues[s].maxDepth << std::endl;
+  }
+  std::cout << std::string(82, '-') << std::endl;
+  std::cout << "Bottleneck stage: " << stageNames[bottleneck] << std::endl;
+
+  const RunStats& latency = result.profiles.back().stats;
+  std::cout << "\nThroughput (ciphertexts/s): pipelined " << std::fixed << std::setprecision(2) << result.pipelinedPerSec
+            << ", serial " << result.serialPerSec
+            << ", speedup " << (result.serialPerSec > 0 ? result.pipelinedPerSec / result.serialPerSec : 0) << "x" << std::endl;
+  std::cout << "End-to-end latency (ms): min " << std::setprecision(3) << latency.min
+            << ", median " << latency.median
+            << ", p90 " << latency.p90
+            << ", p99 " << latency.p99
+            << ", max " << latency.max << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  std::vector<uint32_t> workers = args.getUIntList("stage-workers", {1, 1, 1, 1, 1});
+
+  printThreadingInfo();
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      PipelineResult result = runPipeline(config, args);
+      printPipelineResults(result, workers);
+      resultSets.push_back({config.parameters(), result.profiles});
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-pipeline", resultSets);
+
+  return 0;
+}
@@ -0,0 +1,212 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Ciphertext-plaintext EvalMult and EvalAdd, the common case when model
+// weights are public, under three encoding strategies: encoding the plaintext
+// on every call, reusing one plaintext encoded at level 0, and a cache holding
+// the plaintext encoded at every level the computation reaches. Reports the
+// latency of each strategy per level and the memory the per-level cache costs.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+struct PtxtRow {
+  uint32_t level;
+  size_t towers;
+  std::vector<ProfileData> profiles;
+};
+
+static double median(const std::vector<ProfileData>& profiles, const std::string& name)
+{
+  for (const auto& profile : profiles) {
+    if (profile.operationName == name) {
+      return profile.stats.median;
+    }
+  }
+  return 0;
+}
+
+// In-memory size of a plaintext with the given number of towers: one 64-bit word per coefficient.
+static double plaintextMB(size_t towers, uint32_t ringDim)
+{
+  return towers * double(ringDim) * sizeof(uint64_t) / (1 << 20);
+}
+
+// Ciphertexts are brought to each level with LevelReduce, hence FIXEDMANUAL scaling.
+static std::vector<PtxtRow> runPtxt(const CKKSConfig& config, const std::vector<uint32_t>& levels, const ProfileOptions& options)
+{
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  KeyPair<DCRTPoly> keys = cc->KeyGen();
+  cc->EvalMultKeyGen(keys.secretKey);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+  const std::vector<double>& weights = inputs.x2;
+
+  Plaintext reused = cc->MakeCKKSPackedPlaintext(weights);
+  // one entry per level the computation reaches
+  std::map<uint32_t, Plaintext> cache;
+  for (uint32_t level : levels) {
+    cache[level] = cc->MakeCKKSPackedPlaintext(weights, 1, level);
+  }
+
+  std::vector<PtxtRow> rows;
+  for (uint32_t level : levels) {
+    Ciphertext<DCRTPoly> c = level > 0 ? cc->LevelReduce(inputs.c1, nullptr, level) : inputs.c1;
+    Ciphertext<DCRTPoly> c2 = level > 0 ? cc->LevelReduce(inputs.c2, nullptr, level) : inputs.c2;
+    const Plaintext& cached = cache[level];
+
+    PtxtRow row;
+    row.level = level;
+    row.towers = c->GetElements()[0].GetNumOfElements();
+    row.profiles.push_back(measureOperation("Encode", options, [&] { return cc->MakeCKKSPackedPlaintext(weights, 1, level); }));
+    row.profiles.push_back(measureOperation("EvalMult pt (encode)", options,
+                                            [&] { return cc->EvalMult(c, cc->MakeCKKSPackedPlaintext(weights, 1, level)); }));
+    row.profiles.push_back(measureOperation("EvalMult pt (reuse L0)", options, [&] { return cc->EvalMult(c, reused); }));
+    row.profiles.push_back(measureOperation("EvalMult pt (cached)", options, [&] { return cc->EvalMult(c, cached); }));
+    row.profiles.push_back(measureOperation("EvalAdd pt (encode)", options,
+                                            [&] { return cc->EvalAdd(c, cc->MakeCKKSPackedPlaintext(weights, 1, level)); }));
+    row.profiles.push_back(measureOperation("EvalAdd pt (reuse L0)", options, [&] { return cc->EvalAdd(c, reused); }));
+    row.profiles.push_back(measureOperation("EvalAdd pt (cached)", options, [&] { return cc->EvalAdd(c, cached); }));
+    row.profiles.push_back(measureOperation("EvalMult (ciphertext)", options, [&] { return cc->EvalMult(c, c2); }));
+    rows.push_back(row);
+  }
+
+  cc->ClearEvalMultKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return rows;
+}
+
+static void printPtxtResults(const std::vector<PtxtRow>& rows, uint32_t ringDim)
+{
+  std::cout << "\n============ Plaintext Operand Strategies (median ms) ============\n";
+  std::cout << std::left << std::setw(7) << "Level"
+            << std::right << std::setw(8) << "Towers"
+            << std::right << std::setw(10) << "Encode"
+            << std::right << std::setw(14) << "Mult encode"
+            << std::right << std::setw(13) << "Mult reuse"
+            << std::right << std::setw(13) << "Mult cache"
+            << std::right << std::setw(13) << "Add encode"
+            << std::right << std::setw(12) << "Add reuse"
+            << std::right << std::setw(12) << "Add cache"
+            << std::right << std::setw(14) << "Mult ctxt"
+            << std::right << std::setw(13) << "Entry (MB)" << std::endl;
+  std::cout << std::string(129, '-') << std::endl;
+
+  // profile name and column width, in the order of the header
+  const std::vector<std::pair<std::string, int>> columns = {
+    {"Encode", 10}, {"EvalMult pt (encode)", 14}, {"EvalMult pt (reuse L0)", 13}, {"EvalMult pt (cached)", 13},
+    {"EvalAdd pt (encode)", 13}, {"EvalAdd pt (reuse L0)", 12}, {"EvalAdd pt (cached)", 12}, {"EvalMult (ciphertext)", 14},
+  };
+
+  double cacheMB = 0;
+  double savedVsEncode = 0;
+  double savedVsReuse = 0;
+  for (const auto& row : rows) {
+    const auto& p = row.profiles;
+    double entryMB = plaintextMB(row.towers, ringDim);
+    cacheMB += entryMB;
+    savedVsEncode += median(p, "EvalMult pt (encode)") - median(p, "EvalMult pt (cached)");
+    savedVsReuse += median(p, "EvalMult pt (reuse L0)") - median(p, "EvalMult pt (cached)");
+    std::cout << std::left << std::setw(7) << row.level
+              << std::right << std::setw(8) << row.towers;
+    for (const auto& column : columns) {
+      std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(column.second) << median(p, column.first);
+    }
+    std::cout << std::right << std::fixed << std::setprecision(2) << std::setw(13) << entryMB << std::endl;
+  }
+  std::cout << std::string(129, '-') << std::endl;
+
+  if (!rows.empty()) {
+    std::cout << "Caching one plaintext at the " << rows.size() << " measured level(s) costs "
+              << std::fixed << std::setprecision(2) << cacheMB << " MB; per multiplication it saves on average "
+              << std::setprecision(3) << savedVsEncode / rows.size() << " ms against encoding every call and "
+              << savedVsReuse / rows.size() << " ms against reusing the level-0 plaintext." << std::endl;
+  }
+  std::cout << "Entry (MB) is the in-memory size of one cached plaintext at that level (towers x N x 8 bytes)." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.maxRuns = 20;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  printThreadingInfo();
+
+  std::vector<ResultSet> resultSets;
+  for (CKKSConfig config : buildConfigGrid(args)) {
+    config.scalingTechnique = FIXEDMANUAL;
+    std::vector<uint32_t> allLevels;
+    for (uint32_t level = 0; level < config.multDepth; level++) {
+      allLevels.push_back(level);
+    }
+    std::vector<uint32_t> levels;
+    for (uint32_t level : args.getUIntList("levels", allLevels)) {
+      // the last level has no room left for the EvalMult's rescale
+      if (level < config.multDepth) {
+        levels.push_back(level);
+      }
+    }
+
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<PtxtRow> rows = runPtxt(config, levels, options);
+      printPtxtResults(rows, config.ringDim);
+      for (const auto& row : rows) {
+        ParameterList parameters = config.parameters();
+        parameters.push_back({"level", std::to_string(row.level)});
+        parameters.push_back({"towers", std::to_string(row.towers)});
+        resultSets.push_back({parameters, row.profiles});
+      }
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-ptxt", resultSets);
+
+  return 0;
+}
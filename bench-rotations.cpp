@@ -0,0 +1,193 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Compares k independent EvalRotate calls on one ciphertext against a single
+// EvalFastRotationPrecompute followed by k EvalFastRotation calls (hoisting),
+// and reports the smallest k at which hoisting wins.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+struct RotationRow {
+  uint32_t k;
+  ProfileData independent;
+  ProfileData hoisted;
+};
+
+static std::vector<ResultSet> runRotations(const CKKSConfig& config, const std::vector<uint32_t>& ks, const ProfileOptions& options)
+{
+  uint32_t maxK = *std::max_element(ks.begin(), ks.end());
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+
+  printThreadingInfo();
+  std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl;
+  std::cout << "Generating " << maxK << " rotation keys" << std::endl;
+
+  auto keys = cc->KeyGen();
+  std::vector<int32_t> indices;
+  for (uint32_t i = 1; i <= maxK; i++) {
+    indices.push_back(static_cast<int32_t>(i));
+  }
+  cc->EvalRotateKeyGen(keys.secretKey, indices);
+
+  uint32_t seed = 42;
+  std::vector<double> x1 = generateRandomDoubleVector(config.batchSize, seed);
+  Plaintext ptxt1 = cc->MakeCKKSPackedPlaintext(x1);
+  auto c1 = cc->Encrypt(keys.publicKey, ptxt1);
+
+  uint32_t m = cc->GetCyclotomicOrder();
+
+  // hoisted and plain rotations must decrypt to the same values
+  {
+    auto digits = cc->EvalFastRotationPrecompute(c1);
+    Plaintext fast, plain;
+    cc->Decrypt(keys.secretKey, cc->EvalFastRotation(c1, maxK, m, digits), &fast);
+    cc->Decrypt(keys.secretKey, cc->EvalRotate(c1, maxK), &plain);
+    std::vector<double> a = fast->GetRealPackedValue();
+    std::vector<double> b = plain->GetRealPackedValue();
+    double maxError = 0;
+    for (size_t i = 0; i < std::min(a.size(), b.size()); i++) {
+      maxError = std::max(maxError, std::fabs(a[i] - b[i]));
+    }
+    std::cout << "Max difference between EvalFastRotation and EvalRotate by " << maxK << ": " << maxError << std::endl;
+  }
+
+  ProfileData precompute = measureOperation("EvalFastRotationPrecompute", options,
+                                            [&] { cc->EvalFastRotationPrecompute(c1); });
+
+  std::vector<RotationRow> rows;
+  for (uint32_t k : ks) {
+    RotationRow row;
+    row.k = k;
+    row.independent = measureOperation("EvalRotate x " + std::to_string(k), options, [&] {
+      for (uint32_t i = 1; i <= k; i++) {
+        cc->EvalRotate(c1, i);
+      }
+    });
+    row.hoisted = measureOperation("Hoisted x " + std::to_string(k), options, [&] {
+      auto digits = cc->EvalFastRotationPrecompute(c1);
+      for (uint32_t i = 1; i <= k; i++) {
+        cc->EvalFastRotation(c1, i, m, digits);
+      }
+    });
+    rows.push_back(row);
+  }
+
+  std::cout << "\n============ Hoisted Rotation Results ============\n";
+  std::cout << "EvalFastRotationPrecompute (median): " << std::fixed << std::setprecision(3)
+            << precompute.stats.median << " ms" << std::endl;
+  std::cout << std::left << std::setw(6) << "k"
+            << std::right << std::setw(20) << "EvalRotate (ms)"
+            << std::right << std::setw(18) << "Hoisted (ms)"
+            << std::right << std::setw(22) << "EvalRotate/rot (ms)"
+            << std::right << std::setw(20) << "Hoisted/rot (ms)"
+            << std::right << std::setw(12) << "Speedup" << std::endl;
+  std::cout << std::string(98, '-') << std::endl;
+
+  int64_t crossover = -1;
+  for (const auto& row : rows) {
+    double independentMs = row.independent.stats.median;
+    double hoistedMs = row.hoisted.stats.median;
+    if (crossover < 0 && hoistedMs < independentMs) {
+      crossover = row.k;
+    }
+    std::cout << std::left << std::setw(6) << row.k
+              << std::right << std::fixed << std::setprecision(3) << std::setw(20) << independentMs
+              << std::right << std::fixed << std::setprecision(3) << std::setw(18) << hoistedMs
+              << std::right << std::fixed << std::setprecision(3) << std::setw(22) << independentMs / row.k
+              << std::right << std::fixed << std::setprecision(3) << std::setw(20) << hoistedMs / row.k
+              << std::right << std::fixed << std::setprecision(2) << std::setw(11) << independentMs / hoistedMs << "x" << std::endl;
+  }
+  std::cout << std::string(98, '-') << std::endl;
+  if (crossover > 0) {
+    std::cout << "Hoisting is faster from k = " << crossover << " rotations (medians)" << std::endl;
+  }
+  else {
+    std::cout << "Hoisting was not faster for any measured k" << std::endl;
+  }
+
+  std::vector<ResultSet> resultSets;
+  ParameterList precomputeParameters = config.parameters();
+  precomputeParameters.push_back({"k", "0"});
+  resultSets.push_back({precomputeParameters, {precompute}});
+  for (const auto& row : rows) {
+    ParameterList parameterList = config.parameters();
+    parameterList.push_back({"k", std::to_string(row.k)});
+    resultSets.push_back({parameterList, {row.independent, row.hoisted}});
+  }
+
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return resultSets;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.maxRuns = 10;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  std::vector<uint32_t> ks = args.getUIntList("k", parseUIntList("1..64"));
+  if (ks.empty()) {
+    throw std::invalid_argument("--k needs at least one rotation count");
+  }
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<ResultSet> sets = runRotations(config, ks, options);
+      resultSets.insert(resultSets.end(), sets.begin(), sets.end());
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+  writeResults(args, "bench-rotations", resultSets);
+
+  return 0;
+}
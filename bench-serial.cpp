@@ -0,0 +1,390 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Serializes and deserializes the objects a deployment moves over the network
+// or loads from disk: the crypto context, the public key, relinearization,
+// rotation and bootstrapping keys, and ciphertexts, in binary and JSON format.
+// Evaluation key files are also loaded both through std::ifstream and through
+// a read-only memory mapping.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "mapped-file.h"
+#include "results.h"
+#include "openfhe.h"
+
+#include "ciphertext-ser.h"
+#include "cryptocontext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+using namespace lbcrypto;
+
+// An object that can be written to a stream and read back in one format.
+struct SerialTarget {
+  std::string name;
+  std::function<void(std::ostream&)> save;
+  std::function<void(std::istream&)> load;
+};
+
+struct SerialRow {
+  std::string object;
+  std::string format;
+  size_t bytes;
+  double serializeMs;
+  double deserializeMs;
+};
+
+struct LoadRow {
+  std::string object;
+  size_t bytes;
+  double streamMs;
+  double mappedMs;
+};
+
+// Eval keys live in static maps inside CryptoContextImpl, so serializing them
+// writes every key OpenFHE currently holds; the caller keeps only one context's keys alive.
+template <typename ST>
+static std::vector<SerialTarget> makeLeveledTargets(const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& keys,
+                                                    const OpInputs& inputs, const ST& sertype)
+{
+  return {
+    {"CryptoContext",
+     [cc, sertype](std::ostream& os) { Serial::Serialize(cc, os, sertype); },
+     [sertype](std::istream& is) {
+       CryptoContext<DCRTPoly> loaded;
+       Serial::Deserialize(loaded, is, sertype);
+     }},
+    {"PublicKey",
+     [keys, sertype](std::ostream& os) { Serial::Serialize(keys.publicKey, os, sertype); },
+     [sertype](std::istream& is) {
+       PublicKey<DCRTPoly> loaded;
+       Serial::Deserialize(loaded, is, sertype);
+     }},
+    {"EvalMultKey",
+     [sertype](std::ostream& os) { CryptoContextImpl<DCRTPoly>::SerializeEvalMultKey(os, sertype); },
+     [sertype](std::istream& is) { CryptoContextImpl<DCRTPoly>::DeserializeEvalMultKey(is, sertype); }},
+    {"EvalRotateKeys",
+     [sertype](std::ostream& os) { CryptoContextImpl<DCRTPoly>::SerializeEvalAutomorphismKey(os, sertype); },
+     [sertype](std::istream& is) { CryptoContextImpl<DCRTPoly>::DeserializeEvalAutomorphismKey(is, sertype); }},
+    {"Ciphertext",
+     [inputs, sertype](std::ostream& os) { Serial::Serialize(inputs.c1, os, sertype); },
+     [sertype](std::istream& is) {
+       Ciphertext<DCRTPoly> loaded;
+       Serial::Deserialize(loaded, is, sertype);
+     }},
+    {"Ciphertext (deg 2)",
+     [inputs, sertype](std::ostream& os) { Serial::Serialize(inputs.cMulNoRelin, os, sertype); },
+     [sertype](std::istream& is) {
+       Ciphertext<DCRTPoly> loaded;
+       Serial::Deserialize(loaded, is, sertype);
+     }},
+  };
+}
+
+template <typename ST>
+static std::vector<SerialTarget> makeBootstrapTargets(const Ciphertext<DCRTPoly>& bootstrapped, const ST& sertype)
+{
+  return {
+    {"Boot EvalMultKey",
+     [sertype](std::ostream& os) { CryptoContextImpl<DCRTPoly>::SerializeEvalMultKey(os, sertype); },
+     [sertype](std::istream& is) { CryptoContextImpl<DCRTPoly>::DeserializeEvalMultKey(is, sertype); }},
+    {"Boot EvalRotateKeys",
+     [sertype](std::ostream& os) { CryptoContextImpl<DCRTPoly>::SerializeEvalAutomorphismKey(os, sertype); },
+     [sertype](std::istream& is) { CryptoContextImpl<DCRTPoly>::DeserializeEvalAutomorphismKey(is, sertype); }},
+    {"Ciphertext (boot)",
+     [bootstrapped, sertype](std::ostream& os) { Serial::Serialize(bootstrapped, os, sertype); },
+     [sertype](std::istream& is) {
+       Ciphertext<DCRTPoly> loaded;
+       Serial::Deserialize(loaded, is, sertype);
+     }},
+  };
+}
+
+template <typename ST>
+static std::vector<SerialTarget> makeTargets(bool bootstrap, const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& keys,
+                                             const OpInputs& inputs, const Ciphertext<DCRTPoly>& bootstrapped, const ST& sertype)
+{
+  return bootstrap ? makeBootstrapTargets(bootstrapped, sertype) : makeLeveledTargets(cc, keys, inputs, sertype);
+}
+
+// Both directions work on memory so that only (de)serialization is timed;
+// deserialization reads through MemoryStreamBuf to avoid copying the buffer per run.
+static void profileTargets(const std::vector<SerialTarget>& targets, const std::string& format, const ProfileOptions& options,
+                           std::vector<ProfileData>& profiles, std::vector<SerialRow>& rows)
+{
+  for (const auto& target : targets) {
+    profiles.push_back(measureOperation("Serialize " + target.name, options, [&target] {
+      std::ostringstream os;
+      target.save(os);
+    }));
+    std::ostringstream os;
+    target.save(os);
+    const std::string data = os.str();
+    profiles.back().outputBytes = data.size();
+    double serializeMs = profiles.back().stats.median;
+
+    profiles.push_back(measureOperation("Deserialize " + target.name, options, [&target, &data] {
+      MemoryStreamBuf buffer(data.data(), data.size());
+      std::istream is(&buffer);
+      target.load(is);
+    }));
+    profiles.back().outputBytes = data.size();
+
+    rows.push_back({target.name, format, data.size(), serializeMs, profiles.back().stats.median});
+  }
+}
+
+// Writes the target to a binary file and loads it back through std::ifstream
+// and through a memory mapping of the file. Both paths read from the page cache.
+static void profileFileLoad(const SerialTarget& target, const std::string& dir, const ProfileOptions& options,
+                            std::vector<ProfileData>& profiles, std::vector<LoadRow>& rows)
+{
+  std::string path = (std::filesystem::path(dir) / ("bench-serial-" + std::to_string(rows.size()) + ".bin")).string();
+  {
+    std::ofstream file(path, std::ios::binary);
+    target.save(file);
+    if (!file) {
+      throw std::runtime_error("Cannot write " + path);
+    }
+  }
+  size_t bytes = std::filesystem::file_size(path);
+
+  profiles.push_back(measureOperation("Load " + target.name + " (ifstream)", options, [&target, &path] {
+    std::ifstream file(path, std::ios::binary);
+    target.load(file);
+  }));
+  profiles.back().outputBytes = bytes;
+  double streamMs = profiles.back().stats.median;
+
+  profiles.push_back(measureOperation("Load " + target.name + " (mmap)", options, [&target, &path] {
+    MappedFile mapped(path);
+    MemoryStreamBuf buffer(mapped.data(), mapped.size());
+    std::istream is(&buffer);
+    target.load(is);
+  }));
+  profiles.back().outputBytes = bytes;
+
+  rows.push_back({target.name, bytes, streamMs, profiles.back().stats.median});
+  std::remove(path.c_str());
+}
+
+static double megabytesPerSecond(size_t bytes, double ms)
+{
+  return ms > 0 ? (bytes / 1e6) / (ms / 1e3) : 0;
+}
+
+static void printSerialResults(const std::vector<SerialRow>& rows)
+{
+  std::cout << "\n============ Serialization Results ============\n";
+  std::cout << std::left << std::setw(22) << "Object"
+            << std::left << std::setw(8) << "Format"
+            << std::right << std::setw(14) << "Size (MB)"
+            << std::right << std::setw(16) << "Serialize (ms)"
+            << std::right << std::setw(10) << "MB/s"
+            << std::right << std::setw(18) << "Deserialize (ms)"
+            << std::right << std::setw(10) << "MB/s" << std::endl;
+  std::cout << std::string(98, '-') << std::endl;
+
+  for (const auto& row : rows) {
+    std::cout << std::left << std::setw(22) << row.object
+              << std::left << std::setw(8) << row.format
+              << std::right << std::fixed << std::setprecision(3) << std::setw(14) << row.bytes / 1e6
+              << std::right << std::fixed << std::setprecision(3) << std::setw(16) << row.serializeMs
+              << std::right << std::fixed << std::setprecision(1) << std::setw(10) << megabytesPerSecond(row.bytes, row.serializeMs)
+              << std::right << std::fixed << std::setprecision(3) << std::setw(18) << row.deserializeMs
+              << std::right << std::fixed << std::setprecision(1) << std::setw(10) << megabytesPerSecond(row.bytes, row.deserializeMs) << std::endl;
+  }
+  std::cout << std::string(98, '-') << std::endl;
+  std::cout << "Latencies are medians; MB/s is the serialized size over the median latency." << std::endl;
+}
+
+static void printLoadResults(const std::vector<LoadRow>& rows)
+{
+  std::cout << "\n============ Eval Key File Loading (binary) ============\n";
+  std::cout << std::left << std::setw(22) << "Object"
+            << std::right << std::setw(14) << "Size (MB)"
+            << std::right << std::setw(16) << "ifstream (ms)"
+            << std::right << std::setw(10) << "MB/s"
+            << std::right << std::setw(12) << "mmap (ms)"
+            << std::right << std::setw(10) << "MB/s"
+            << std::right << std::setw(10) << "Speedup" << std::endl;
+  std::cout << std::string(94, '-') << std::endl;
+
+  for (const auto& row : rows) {
+    std::cout << std::left << std::setw(22) << row.object
+              << std::right << std::fixed << std::setprecision(3) << std::setw(14) << row.bytes / 1e6
+              << std::right << std::fixed << std::setprecision(3) << std::setw(16) << row.streamMs
+              << std::right << std::fixed << std::setprecision(1) << std::setw(10) << megabytesPerSecond(row.bytes, row.streamMs)
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << row.mappedMs
+              << std::right << std::fixed << std::setprecision(1) << std::setw(10) << megabytesPerSecond(row.bytes, row.mappedMs)
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << (row.mappedMs > 0 ? row.streamMs / row.mappedMs : 0) << std::endl;
+  }
+  std::cout << std::string(94, '-') << std::endl;
+  std::cout << "Files are read from the page cache; drop it beforehand to include disk reads." << std::endl;
+}
+
+struct SerialResult {
+  std::vector<ResultSet> resultSets;
+  std::vector<SerialRow> serialRows;
+  std::vector<LoadRow> loadRows;
+};
+
+// Runs every requested format over the targets of one phase (leveled or bootstrapping),
+// then loads the phase's eval key files through both file paths.
+static void runPhase(bool bootstrap, const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& keys, const OpInputs& inputs,
+                     const Ciphertext<DCRTPoly>& bootstrapped, const ParameterList& parameters,
+                     const std::vector<std::string>& formats, const std::string& dir, const ProfileOptions& options,
+                     SerialResult& result)
+{
+  for (const auto& format : formats) {
+    ResultSet set;
+    set.parameters = parameters;
+    set.parameters.push_back({"format", format});
+    if (format == "binary") {
+      profileTargets(makeTargets(bootstrap, cc, keys, inputs, bootstrapped, SerType::BINARY), format, options, set.profiles, result.serialRows);
+    }
+    else if (format == "json") {
+      profileTargets(makeTargets(bootstrap, cc, keys, inputs, bootstrapped, SerType::JSON), format, options, set.profiles, result.serialRows);
+    }
+    else {
+      throw std::invalid_argument("Unknown serialization format: " + format);
+    }
+    result.resultSets.push_back(set);
+  }
+
+  ResultSet files;
+  files.parameters = parameters;
+  files.parameters.push_back({"format", "binary-file"});
+  for (const auto& target : makeTargets(bootstrap, cc, keys, inputs, bootstrapped, SerType::BINARY)) {
+    if (target.name.find("Eval") != std::string::npos) {
+      profileFileLoad(target, dir, options, files.profiles, result.loadRows);
+    }
+  }
+  result.resultSets.push_back(files);
+}
+
+static SerialResult runSerial(const CKKSConfig& config, const std::vector<std::string>& formats, bool withBootstrap,
+                              const std::string& dir, const ProfileOptions& options)
+{
+  SerialResult result;
+
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  KeyPair<DCRTPoly> keys = generateAddMulKeys(cc);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+
+  ParameterList parameters = config.parameters();
+  parameters.push_back({"phase", "leveled"});
+  runPhase(false, cc, keys, inputs, nullptr, parameters, formats, dir, options, result);
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  if (!withBootstrap) {
+    return result;
+  }
+
+  // same bootstrapping context as bench-setup
+  std::vector<uint32_t> levelBudget = {4, 4};
+  uint32_t levelsAvailableAfterBootstrap = 3;
+  CKKSConfig bootConfig = config;
+  bootConfig.multDepth = levelsAvailableAfterBootstrap + FHECKKSRNS::GetBootstrapDepth(levelBudget, UNIFORM_TERNARY);
+
+  CryptoContext<DCRTPoly> bootCc = makeCKKSContext(bootConfig);
+  bootCc->Enable(ADVANCEDSHE);
+  bootCc->Enable(FHE);
+  bootCc->EvalBootstrapSetup(levelBudget, {0, 0}, config.batchSize);
+  KeyPair<DCRTPoly> bootKeys = bootCc->KeyGen();
+  bootCc->EvalMultKeyGen(bootKeys.secretKey);
+  bootCc->EvalBootstrapKeyGen(bootKeys.secretKey, config.batchSize);
+
+  std::vector<double> x = generateRandomDoubleVector(config.batchSize, 42);
+  Plaintext ptxt = bootCc->MakeCKKSPackedPlaintext(x, 1, bootConfig.multDepth - 1, nullptr, config.batchSize);
+  Ciphertext<DCRTPoly> bootstrapped = bootCc->EvalBootstrap(bootCc->Encrypt(bootKeys.publicKey, ptxt));
+
+  parameters = bootConfig.parameters();
+  parameters.push_back({"phase", "bootstrap"});
+  runPhase(true, bootCc, bootKeys, inputs, bootstrapped, parameters, formats, dir, options, result);
+
+  bootCc->ClearEvalMultKeys();
+  bootCc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  return result;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.minRuns = 3;
+  defaults.maxRuns = 10;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  std::vector<std::string> formats = args.getList("formats", {"binary", "json"});
+  bool withBootstrap = !args.has("skip-bootstrap");
+  std::string dir = args.get("dir", std::filesystem::temp_directory_path().string());
+
+  printThreadingInfo();
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      SerialResult result = runSerial(config, formats, withBootstrap, dir, options);
+      printSerialResults(result.serialRows);
+      printLoadResults(result.loadRows);
+      resultSets.insert(resultSets.end(), result.resultSets.begin(), result.resultSets.end());
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-serial", resultSets);
+
+  return 0;
+}
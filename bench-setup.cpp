@@ -0,0 +1,172 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Times every setup phase that runs before the first homomorphic operation:
+// context generation, key generation, relinearization and rotation key
+// generation, and bootstrapping setup and key generation. Each phase also
+// reports the memory it allocates and the serialized size of the keys it produces.
+
+#define PROFILE
+#include <iostream>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+// Key generation is normally timed once; on repeated runs each timed call first
+// drops the keys of the previous run so that every run generates the full key set.
+static std::vector<ProfileData> runSetup(const CKKSConfig& config, const std::vector<uint32_t>& numRotations,
+                                         bool withBootstrap, const ProfileOptions& options)
+{
+  std::vector<ProfileData> profiles;
+
+  // GenCryptoContext returns a cached context for known parameters, so the
+  // factory is emptied before every run; old contexts are freed after timing
+  std::vector<CryptoContext<DCRTPoly>> retired;
+  CryptoContext<DCRTPoly> cc;
+  profiles.push_back(measureOperation("GenCryptoContext", options, [&] {
+    retired.push_back(cc);
+    CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+    cc = makeCKKSContext(config);
+  }));
+  retired.clear();
+
+  KeyPair<DCRTPoly> keys;
+  profiles.push_back(measureOperation("KeyGen", options, [&] { keys = cc->KeyGen(); }));
+  profiles.back().outputBytes = serializedSize(keys.publicKey) + serializedSize(keys.secretKey);
+
+  profiles.push_back(measureOperation("EvalMultKeyGen", options, [&] {
+    cc->ClearEvalMultKeys();
+    cc->EvalMultKeyGen(keys.secretKey);
+  }));
+  profiles.back().outputBytes = serializedEvalMultKeySize();
+
+  for (uint32_t n : numRotations) {
+    std::vector<int32_t> indices;
+    for (uint32_t i = 1; i <= n; i++) {
+      indices.push_back(static_cast<int32_t>(i));
+    }
+    profiles.push_back(measureOperation("EvalRotateKeyGen (" + std::to_string(n) + ")", options, [&] {
+      cc->ClearEvalAutomorphismKeys();
+      cc->EvalRotateKeyGen(keys.secretKey, indices);
+    }));
+    profiles.back().outputBytes = serializedEvalAutomorphismKeySize();
+  }
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  if (!withBootstrap) {
+    return profiles;
+  }
+
+  // bootstrapping needs its own, deeper context
+  std::vector<uint32_t> levelBudget = {4, 4};
+  uint32_t levelsAvailableAfterBootstrap = 3;
+  CKKSConfig bootConfig = config;
+  bootConfig.multDepth = levelsAvailableAfterBootstrap + FHECKKSRNS::GetBootstrapDepth(levelBudget, UNIFORM_TERNARY);
+
+  CryptoContext<DCRTPoly> bootCc;
+  profiles.push_back(measureOperation("GenCryptoContext (boot)", options, [&] {
+    retired.push_back(bootCc);
+    CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+    bootCc = makeCKKSContext(bootConfig);
+    bootCc->Enable(ADVANCEDSHE);
+    bootCc->Enable(FHE);
+  }));
+  retired.clear();
+
+  profiles.push_back(measureOperation("EvalBootstrapSetup", options, [&] {
+    bootCc->EvalBootstrapSetup(levelBudget, {0, 0}, config.batchSize);
+  }));
+
+  KeyPair<DCRTPoly> bootKeys = bootCc->KeyGen();
+  profiles.push_back(measureOperation("EvalBootstrapKeyGen", options, [&] {
+    bootCc->ClearEvalMultKeys();
+    bootCc->ClearEvalAutomorphismKeys();
+    bootCc->EvalBootstrapKeyGen(bootKeys.secretKey, config.batchSize);
+  }));
+  profiles.back().outputBytes = serializedEvalMultKeySize() + serializedEvalAutomorphismKeySize();
+
+  bootCc->ClearEvalMultKeys();
+  bootCc->ClearEvalAutomorphismKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+  return profiles;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.warmupRuns = 0;
+  defaults.minRuns = 1;
+  defaults.maxRuns = 1;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+
+  std::vector<uint32_t> numRotations = args.getUIntList("num-rotations", {1, 8, 32});
+  bool withBootstrap = !args.has("skip-bootstrap");
+
+  printThreadingInfo();
+
+  std::vector<SweepResult> results;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<ProfileData> profiles = runSetup(config, numRotations, withBootstrap, options);
+      printProfileResults(profiles);
+      results.push_back({config, profiles});
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  if (results.size() > 1) {
+    printSweepResults(results);
+  }
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& result : results) {
+    resultSets.push_back({result.config.parameters(), result.profiles});
+  }
+  writeResults(args, "bench-setup", resultSets);
+
+  return 0;
+}
@@ -0,0 +1,234 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Pairs every encrypted operation of bench-add-mul (plus EvalSum) with its
+// plaintext equivalent on the same data and reports the slowdown, the cost per
+// element and the error of the decrypted result against the plaintext one.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "simd-kernels.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+// Plaintext counterpart of one encrypted operation. plain writes its result to out;
+// the reference is what the decrypted encrypted result should be, by default plain's output.
+struct PlainOp {
+  std::string opName;
+  std::string plainName;
+  std::function<void(std::vector<double>& out)> plain;
+  std::vector<double> reference;
+};
+
+struct SlowdownRow {
+  std::string opName;
+  std::string plainName;
+  double encryptedMs;
+  double plainMs;
+  double maxError;
+};
+
+// Plaintext code uses the fastest SIMD kernels of the CPU so that the ratio is
+// against the best plaintext implementation, not against allocating loops.
+static std::vector<PlainOp> makePlainOps(const OpInputs& in)
+{
+  const SimdKernels& kernels = simdKernels();
+  const std::vector<double>& x1 = in.x1;
+  const std::vector<double>& x2 = in.x2;
+  size_t n = x1.size();
+
+  auto copy = [&x1, n](std::vector<double>& out) { std::memcpy(out.data(), x1.data(), n * sizeof(double)); };
+  std::vector<double> product(n);
+  kernels.multiply(x1.data(), x2.data(), product.data(), n);
+  double sum = std::accumulate(x1.begin(), x1.end(), 0.0);
+
+  return {
+    {"MakeCKKSPackedPlaintext", "memcpy", copy, {}},
+    {"Encrypt", "memcpy", copy, {}},
+    {"EvalAdd", "add", [&kernels, &x1, &x2, n](std::vector<double>& out) { kernels.add(x1.data(), x2.data(), out.data(), n); }, {}},
+    {"EvalSub", "subtract", [&kernels, &x1, &x2, n](std::vector<double>& out) { kernels.subtract(x1.data(), x2.data(), out.data(), n); }, {}},
+    {"EvalMult (scalar)", "scale", [&kernels, &x1, n](std::vector<double>& out) { kernels.scale(x1.data(), 4.0, out.data(), n); }, {}},
+    {"EvalMult (ciphertext)", "multiply", [&kernels, &x1, &x2, n](std::vector<double>& out) { kernels.multiply(x1.data(), x2.data(), out.data(), n); }, {}},
+    {"EvalMultNoRelin", "multiply", [&kernels, &x1, &x2, n](std::vector<double>& out) { kernels.multiply(x1.data(), x2.data(), out.data(), n); }, {}},
+    // relinearization leaves the message unchanged, so its plaintext analogue is a copy
+    {"Relinearize", "memcpy", copy, product},
+    {"EvalRotate (1)", "std::rotate", [&x1](std::vector<double>& out) { std::rotate_copy(x1.begin(), x1.begin() + 1, x1.end(), out.begin()); }, {}},
+    {"EvalRotate (-2)", "std::rotate", [&x1](std::vector<double>& out) { std::rotate_copy(x1.begin(), x1.end() - 2, x1.end(), out.begin()); }, {}},
+    {"Decrypt", "memcpy", copy, {}},
+    {"EvalSum", "std::accumulate", [&x1](std::vector<double>& out) { out[0] = std::accumulate(x1.begin(), x1.end(), 0.0); }, std::vector<double>(n, sum)},
+  };
+}
+
+static double maxAbsError(const std::vector<double>& values, const std::vector<double>& expected)
+{
+  double maxError = 0;
+  for (size_t i = 0; i < expected.size() && i < values.size(); i++) {
+    maxError = std::max(maxError, std::fabs(values[i] - expected[i]));
+  }
+  return maxError;
+}
+
+static std::vector<double> decryptValues(const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& keys,
+                                         const Ciphertext<DCRTPoly>& ciphertext, uint32_t batchSize)
+{
+  Plaintext result;
+  cc->Decrypt(keys.secretKey, ciphertext, &result);
+  result->SetLength(batchSize);
+  return result->GetRealPackedValue();
+}
+
+static std::vector<SlowdownRow> runSlowdown(const CKKSConfig& config, const ProfileOptions& options,
+                                            const ProfileOptions& plainOptions, std::vector<ProfileData>& profiles)
+{
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  cc->Enable(ADVANCEDSHE);
+  KeyPair<DCRTPoly> keys = generateAddMulKeys(cc);
+  cc->EvalSumKeyGen(keys.secretKey);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+
+  std::vector<BenchOp> ops = makeAddMulOps(cc, keys);
+  ops.push_back({"EvalSum", [cc, batchSize = config.batchSize](const OpInputs& in) { return cc->EvalSum(in.c1, batchSize); }});
+
+  std::vector<SlowdownRow> rows;
+  std::vector<double> out(config.batchSize);
+  for (const auto& pair : makePlainOps(inputs)) {
+    auto op = std::find_if(ops.begin(), ops.end(), [&pair](const BenchOp& o) { return o.name == pair.opName; });
+    profiles.push_back(profileOp(*op, inputs, options));
+    double encryptedMs = profiles.back().stats.median;
+
+    profiles.push_back(measureOperation("Plain " + pair.opName, plainOptions, [&pair, &out] { pair.plain(out); }));
+    double plainMs = profiles.back().stats.median;
+
+    std::vector<double> reference = pair.reference;
+    if (reference.empty()) {
+      pair.plain(out);
+      reference = out;
+    }
+
+    // operations producing a plaintext are checked through their own output
+    std::vector<double> values;
+    if (pair.opName == "MakeCKKSPackedPlaintext") {
+      Plaintext encoded = cc->MakeCKKSPackedPlaintext(inputs.x1);
+      encoded->SetLength(config.batchSize);
+      values = encoded->GetRealPackedValue();
+    }
+    else if (pair.opName == "Decrypt") {
+      values = decryptValues(cc, keys, inputs.c1, config.batchSize);
+    }
+    else {
+      values = decryptValues(cc, keys, op->run(inputs), config.batchSize);
+    }
+
+    rows.push_back({pair.opName, pair.plainName, encryptedMs, plainMs, maxAbsError(values, reference)});
+  }
+
+  cc->ClearEvalMultKeys();
+  cc->ClearEvalAutomorphismKeys();
+  cc->ClearEvalSumKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return rows;
+}
+
+static void printSlowdownResults(const std::vector<SlowdownRow>& rows, uint32_t batchSize)
+{
+  std::cout << "\n============ Encrypted vs Plaintext ============\n";
+  std::cout << std::left << std::setw(25) << "Operation"
+            << std::left << std::setw(18) << "Plaintext"
+            << std::right << std::setw(12) << "Enc (ms)"
+            << std::right << std::setw(12) << "Plain (ms)"
+            << std::right << std::setw(12) << "Slowdown"
+            << std::right << std::setw(16) << "Enc ns/elem"
+            << std::right << std::setw(16) << "Plain ns/elem"
+            << std::right << std::setw(14) << "Max error"
+            << std::right << std::setw(8) << "Bits" << std::endl;
+  std::cout << std::string(133, '-') << std::endl;
+
+  for (const auto& row : rows) {
+    std::cout << std::left << std::setw(25) << row.opName
+              << std::left << std::setw(18) << row.plainName
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << row.encryptedMs
+              << std::right << std::fixed << std::setprecision(5) << std::setw(12) << row.plainMs
+              << std::right << std::fixed << std::setprecision(0) << std::setw(12) << (row.plainMs > 0 ? row.encryptedMs / row.plainMs : 0)
+              << std::right << std::fixed << std::setprecision(2) << std::setw(16) << row.encryptedMs * 1e6 / batchSize
+              << std::right << std::fixed << std::setprecision(4) << std::setw(16) << row.plainMs * 1e6 / batchSize
+              << std::right << std::scientific << std::setprecision(2) << std::setw(14) << row.maxError
+              << std::right << std::fixed << std::setprecision(1) << std::setw(8) << (row.maxError > 0 ? -std::log2(row.maxError) : 0.0)
+              << std::defaultfloat << std::endl;
+  }
+  std::cout << std::string(133, '-') << std::endl;
+  std::cout << "Latencies are medians; Bits = -log2(max error) of the decrypted result against the plaintext one." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions options = profileOptionsFromArgs(args, ProfileOptions());
+  // plaintext operations take microseconds and need more samples
+  ProfileOptions plainDefaults;
+  plainDefaults.maxRuns = 1000;
+  ProfileOptions plainOptions = profileOptionsFromArgs(args, plainDefaults);
+
+  printThreadingInfo();
+  std::cout << "Plaintext SIMD kernels: " << simdLevelName(detectSimdLevel()) << std::endl;
+
+  std::vector<ResultSet> resultSets;
+  for (const auto& config : buildConfigGrid(args)) {
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<ProfileData> profiles;
+      std::vector<SlowdownRow> rows = runSlowdown(config, options, plainOptions, profiles);
+      printSlowdownResults(rows, config.batchSize);
+      resultSets.push_back({config.parameters(), profiles});
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-slowdown", resultSets);
+
+  return 0;
+}
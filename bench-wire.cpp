@@ -0,0 +1,245 @@
+//==================================================================================
+// BSD 2-Clause License
+//
+// Copyright (c) 2014-2022, NJIT, Duality Technologies Inc. and other contributors
+//
+// All rights reserved.
+//
+// Author TPOC: contact@openfhe.org
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//==================================================================================
+
+
+// Wire size of CKKS ciphertexts against the number of towers they keep.
+// A fresh ciphertext and a rescaled product are cut down with Compress and
+// LevelReduce to every tower count, then serialized and decrypted. The report
+// weighs the bytes saved, the transfer time they save on a link of --link-mbps
+// and the faster decryption against the time spent compressing.
+
+#define PROFILE
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "ckks-utils.h"
+#include "results.h"
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+struct WireRow {
+  std::string source;
+  size_t towers;
+  size_t bytes;
+  double precisionBits;
+  std::vector<ProfileData> profiles;
+};
+
+static double median(const std::vector<ProfileData>& profiles, const std::string& name)
+{
+  for (const auto& profile : profiles) {
+    if (profile.operationName == name) {
+      return profile.stats.median;
+    }
+  }
+  return 0;
+}
+
+static double precisionBits(const std::vector<double>& values, const std::vector<double>& expected)
+{
+  double maxError = 0;
+  for (size_t i = 0; i < expected.size() && i < values.size(); i++) {
+    maxError = std::max(maxError, std::fabs(values[i] - expected[i]));
+  }
+  return maxError > 0 ? -std::log2(maxError) : 0;
+}
+
+// Compress and LevelReduce of ciphertext down to every tower count in towerCounts,
+// followed by serialization and decryption of the reduced ciphertext.
+static void profileSource(const std::string& source, const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& keys,
+                          const Ciphertext<DCRTPoly>& ciphertext, const std::vector<double>& expected,
+                          const std::vector<uint32_t>& towerCounts, uint32_t batchSize,
+                          const ProfileOptions& options, std::vector<WireRow>& rows)
+{
+  size_t fullTowers = ciphertext->GetElements()[0].GetNumOfElements();
+  for (uint32_t towers : towerCounts) {
+    if (towers == 0 || towers > fullTowers) {
+      continue;
+    }
+    size_t dropped = fullTowers - towers;
+    Ciphertext<DCRTPoly> reduced = dropped > 0 ? cc->Compress(ciphertext, towers) : ciphertext;
+
+    WireRow row;
+    row.source = source;
+    row.towers = towers;
+    row.bytes = serializedSize(reduced);
+    if (dropped > 0) {
+      row.profiles.push_back(measureOperation("Compress", options, [&] { return cc->Compress(ciphertext, towers); }));
+      row.profiles.push_back(measureOperation("LevelReduce", options, [&] { return cc->LevelReduce(ciphertext, nullptr, dropped); }));
+    }
+    row.profiles.push_back(measureOperation("Serialize", options, [&] { return serializedSize(reduced); }));
+    row.profiles.push_back(measureOperation("Decrypt", options, [&] {
+      Plaintext result;
+      cc->Decrypt(keys.secretKey, reduced, &result);
+    }));
+    for (auto& profile : row.profiles) {
+      profile.outputBytes = row.bytes;
+    }
+
+    Plaintext result;
+    cc->Decrypt(keys.secretKey, reduced, &result);
+    result->SetLength(batchSize);
+    row.precisionBits = precisionBits(result->GetRealPackedValue(), expected);
+    rows.push_back(row);
+  }
+}
+
+// LevelReduce needs FIXEDMANUAL scaling; Compress works under every technique.
+static std::vector<WireRow> runWire(const CKKSConfig& config, const std::vector<uint32_t>& towerCounts, const ProfileOptions& options)
+{
+  CryptoContext<DCRTPoly> cc = makeCKKSContext(config);
+  KeyPair<DCRTPoly> keys = cc->KeyGen();
+  cc->EvalMultKeyGen(keys.secretKey);
+  OpInputs inputs = makeOpInputs(cc, keys, config.batchSize, 42);
+
+  std::vector<WireRow> rows;
+  profileSource("fresh", cc, keys, inputs.c1, inputs.x1, towerCounts, config.batchSize, options, rows);
+  Ciphertext<DCRTPoly> product = cc->Rescale(cc->EvalMult(inputs.c1, inputs.c2));
+  profileSource("product", cc, keys, product, pointwiseMultiply(inputs.x1, inputs.x2), towerCounts, config.batchSize, options, rows);
+
+  cc->ClearEvalMultKeys();
+  CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+  return rows;
+}
+
+static void printWireResults(const std::vector<WireRow>& rows, double linkMbps, double maxBitsLoss)
+{
+  std::cout << "\n============ Wire Size vs Towers (median ms) ============\n";
+  std::cout << std::left << std::setw(9) << "Source"
+            << std::right << std::setw(8) << "Towers"
+            << std::right << std::setw(12) << "Size (KB)"
+            << std::right << std::setw(8) << "Saved"
+            << std::right << std::setw(11) << "Compress"
+            << std::right << std::setw(13) << "LevelReduce"
+            << std::right << std::setw(10) << "Decrypt"
+            << std::right << std::setw(12) << "Wire (ms)"
+            << std::right << std::setw(11) << "Net (ms)"
+            << std::right << std::setw(8) << "Bits" << std::endl;
+  std::cout << std::string(102, '-') << std::endl;
+
+  // milliseconds to send one byte over the link
+  double msPerByte = 8.0 / (linkMbps * 1e3);
+  std::vector<std::string> sources;
+  for (const auto& row : rows) {
+    if (std::find(sources.begin(), sources.end(), row.source) == sources.end()) {
+      sources.push_back(row.source);
+    }
+  }
+
+  for (const auto& source : sources) {
+    const WireRow* full = nullptr;
+    for (const auto& row : rows) {
+      if (row.source == source && (!full || row.towers > full->towers)) {
+        full = &row;
+      }
+    }
+    size_t minTowers = full->towers;
+    for (const auto& row : rows) {
+      if (row.source != source) {
+        continue;
+      }
+      double compressMs = median(row.profiles, "Compress");
+      double decryptMs = median(row.profiles, "Decrypt");
+      double wireMs = row.bytes * msPerByte;
+      // transfer and decryption time saved, less the time spent compressing
+      double netMs = (full->bytes - row.bytes) * msPerByte + median(full->profiles, "Decrypt") - decryptMs - compressMs;
+      if (row.precisionBits >= full->precisionBits - maxBitsLoss) {
+        minTowers = std::min(minTowers, row.towers);
+      }
+      std::cout << std::left << std::setw(9) << row.source
+                << std::right << std::setw(8) << row.towers
+                << std::right << std::fixed << std::setprecision(1) << std::setw(12) << row.bytes / 1024.0
+                << std::right << std::fixed << std::setprecision(1) << std::setw(7) << 100.0 * (1 - double(row.bytes) / full->bytes) << "%"
+                << std::right << std::fixed << std::setprecision(3) << std::setw(11) << compressMs
+                << std::right << std::fixed << std::setprecision(3) << std::setw(13) << median(row.profiles, "LevelReduce")
+                << std::right << std::fixed << std::setprecision(3) << std::setw(10) << decryptMs
+                << std::right << std::fixed << std::setprecision(3) << std::setw(12) << wireMs
+                << std::right << std::fixed << std::setprecision(3) << std::setw(11) << netMs
+                << std::right << std::fixed << std::setprecision(1) << std::setw(8) << row.precisionBits << std::endl;
+    }
+    std::cout << "Minimum towers for " << source << " within " << maxBitsLoss << " bit(s) of full precision: "
+              << minTowers << std::endl;
+  }
+  std::cout << std::string(102, '-') << std::endl;
+  std::cout << "Wire is the transfer time at " << linkMbps << " Mbit/s; Net is the transfer and decryption time saved against "
+            << "the full ciphertext, less Compress." << std::endl;
+  std::cout << "Bits = -log2(max error) of the decrypted result against the plaintext one." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchArgs args = parseArgs(argc, argv);
+  ProfileOptions defaults;
+  defaults.maxRuns = 20;
+  ProfileOptions options = profileOptionsFromArgs(args, defaults);
+  double linkMbps = std::stod(args.get("link-mbps", "1000"));
+  double maxBitsLoss = std::stod(args.get("max-bits-loss", "1"));
+
+  printThreadingInfo();
+
+  std::vector<ResultSet> resultSets;
+  for (CKKSConfig config : buildConfigGrid(args)) {
+    config.scalingTechnique = FIXEDMANUAL;
+    std::vector<uint32_t> allTowers;
+    for (uint32_t towers = config.multDepth + 1; towers >= 1; towers--) {
+      allTowers.push_back(towers);
+    }
+    std::vector<uint32_t> towerCounts = args.getUIntList("towers", allTowers);
+
+    std::cout << "\n============ Configuration: " << config.label() << " ============\n";
+    try {
+      std::vector<WireRow> rows = runWire(config, towerCounts, options);
+      printWireResults(rows, linkMbps, maxBitsLoss);
+      for (const auto& row : rows) {
+        ParameterList parameters = config.parameters();
+        parameters.push_back({"source", row.source});
+        // only the keys go here: bench-compare matches rows on every parameter, and
+        // the measured precision changes from run to run (it stays in the table)
+        parameters.push_back({"towers", std::to_string(row.towers)});
+        resultSets.push_back({parameters, row.profiles});
+      }
+    }
+    catch (const std::exception& e) {
+      std::cout << "Skipping configuration " << config.label() << ": " << e.what() << std::endl;
+    }
+  }
+
+  writeResults(args, "bench-wire", resultSets);
+
+  return 0;
+}
@@ -0,0 +1,266 @@
+#include "ckks-utils.h"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "ciphertext-ser.h"
+#include "cryptocontext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+using namespace lbcrypto;
+
+std::string CKKSConfig::label() const {
+  std::ostringstream ss;
+  ss << "N=2^" << static_cast<uint32_t>(std::log2(ringDim))
+     << " L=" << multDepth
+     << " dq=" << scaleModSize
+     << " q0=" << firstModSize
+     << " slots=" << batchSize;
+  if (keySwitchTechnique == BV) {
+    ss << " ks=BV";
+  }
+  else if (numLargeDigits > 0) {
+    ss << " dnum=" << numLargeDigits;
+  }
+  if (scalingTechnique != FLEXIBLEAUTOEXT) {
+    ss << " scaling=" << scalingTechniqueName(scalingTechnique);
+  }
+  return ss.str();
+}
+
+std::vector<std::pair<std::string, std::string>> CKKSConfig::parameters() const {
+  return {
+    {"ring_dim", std::to_string(ringDim)},
+    {"mult_depth", std::to_string(multDepth)},
+    {"scale_mod_size", std::to_string(scaleModSize)},
+    {"first_mod_size", std::to_string(firstModSize)},
+    {"batch_size", std::to_string(batchSize)},
+    {"key_switch", keySwitchTechnique == BV ? "BV" : "HYBRID"},
+    {"num_large_digits", std::to_string(numLargeDigits)},
+    {"scaling", scalingTechniqueName(scalingTechnique)},
+  };
+}
+
+std::vector<CKKSConfig> buildConfigGrid(const BenchArgs& args) {
+  std::vector<uint32_t> logRingDims = args.getUIntList("log-ring-dim", {16});
+  std::vector<uint32_t> depths = args.getUIntList("depth", {10});
+  std::vector<uint32_t> scaleModSizes = args.getUIntList("scale-mod", {59});
+  std::vector<uint32_t> firstModSizes = args.getUIntList("first-mod", {60});
+  std::vector<uint32_t> logBatchSizes = args.getUIntList("log-batch", {});
+
+  std::vector<CKKSConfig> grid;
+  for (uint32_t logN : logRingDims) {
+    // batch defaults to full packing for every ring dimension
+    std::vector<uint32_t> logBatches = logBatchSizes.empty() ? std::vector<uint32_t>{logN - 1} : logBatchSizes;
+    for (uint32_t depth : depths) {
+      for (uint32_t scaleModSize : scaleModSizes) {
+        for (uint32_t firstModSize : firstModSizes) {
+          for (uint32_t logBatch : logBatches) {
+            if (logBatch >= logN) {
+              std::cout << "Skipping batch size 2^" << logBatch << " for ring dimension 2^" << logN << std::endl;
+              continue;
+            }
+            CKKSConfig config;
+            config.ringDim = (1 << logN);
+            config.multDepth = depth;
+            config.scaleModSize = scaleModSize;
+            config.firstModSize = firstModSize;
+            config.batchSize = (1 << logBatch);
+            grid.push_back(config);
+          }
+        }
+      }
+    }
+  }
+  return grid;
+}
+
+const char* scalingTechniqueName(ScalingTechnique technique) {
+  switch (technique) {
+    case FIXEDMANUAL:
+      return "FIXEDMANUAL";
+    case FIXEDAUTO:
+      return "FIXEDAUTO";
+    case FLEXIBLEAUTO:
+      return "FLEXIBLEAUTO";
+    case FLEXIBLEAUTOEXT:
+      return "FLEXIBLEAUTOEXT";
+    default:
+      return "OTHER";
+  }
+}
+
+ScalingTechnique scalingTechniqueFromName(const std::string& name) {
+  for (ScalingTechnique technique : {FIXEDMANUAL, FIXEDAUTO, FLEXIBLEAUTO, FLEXIBLEAUTOEXT}) {
+    if (name == scalingTechniqueName(technique)) {
+      return technique;
+    }
+  }
+  throw std::invalid_argument("Unknown scaling technique: " + name);
+}
+
+CryptoContext<DCRTPoly> makeCKKSContext(const CKKSConfig& config)
+{
+  CCParams<CryptoContextCKKSRNS> parameters;
+  parameters.SetMultiplicativeDepth(config.multDepth);
+  parameters.SetFirstModSize(config.firstModSize);
+  parameters.SetScalingModSize(config.scaleModSize);
+  parameters.SetBatchSize(config.batchSize);
+  parameters.SetSecurityLevel(HEStd_NotSet);
+  parameters.SetRingDim(config.ringDim);
+  parameters.SetKeySwitchTechnique(config.keySwitchTechnique);
+  parameters.SetScalingTechnique(config.scalingTechnique);
+  if (config.numLargeDigits > 0) {
+    parameters.SetNumLargeDigits(config.numLargeDigits);
+  }
+
+  CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+  cc->Enable(PKE);
+  cc->Enable(KEYSWITCH);
+  cc->Enable(LEVELEDSHE);
+  return cc;
+}
+
+void printModuliChain(const DCRTPoly &poly)
+{
+  int num_primes = poly.GetNumOfElements();
+  double total_bit_len = 0.0;
+  for (int i = 0; i < num_primes; i++)
+  {
+    auto qi = poly.GetParams()->GetParams()[i]->GetModulus();
+    std::cout << "q_" << i << ": "
+              << qi
+              << ",  log q_" << i << ": " << log(qi.ConvertToDouble()) / log(2)
+              << std::endl;
+    total_bit_len += log(qi.ConvertToDouble()) / log(2);
+  }
+  std::cout << "Total bit length: " << total_bit_len << std::endl;
+}
+
+OpInputs makeOpInputs(const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& keys,
+                      uint32_t batchSize, uint32_t seed)
+{
+  OpInputs inputs;
+  inputs.x1 = generateRandomDoubleVector(batchSize, seed);
+  inputs.x2 = generateRandomDoubleVector(batchSize, seed);
+
+  inputs.ptxt1 = cc->MakeCKKSPackedPlaintext(inputs.x1);
+  Plaintext ptxt2 = cc->MakeCKKSPackedPlaintext(inputs.x2);
+
+  inputs.c1 = cc->Encrypt(keys.publicKey, inputs.ptxt1);
+  inputs.c2 = cc->Encrypt(keys.publicKey, ptxt2);
+  inputs.cMulNoRelin = cc->EvalMultNoRelin(inputs.c1, inputs.c2);
+  return inputs;
+}
+
+KeyPair<DCRTPoly> generateAddMulKeys(const CryptoContext<DCRTPoly>& cc)
+{
+  auto keys = cc->KeyGen();
+  cc->EvalMultKeyGen(keys.secretKey);
+  cc->EvalRotateKeyGen(keys.secretKey, {1, -2});
+  return keys;
+}
+
+std::vector<BenchOp> makeAddMulOps(const CryptoContext<DCRTPoly>& cc, const KeyPair<DCRTPoly>& keys)
+{
+  return {
+    {"MakeCKKSPackedPlaintext", [cc](const OpInputs& in) {
+       cc->MakeCKKSPackedPlaintext(in.x1);
+       return Ciphertext<DCRTPoly>();
+     }},
+    {"Encrypt", [cc, keys](const OpInputs& in) { return cc->Encrypt(keys.publicKey, in.ptxt1); }},
+    {"EvalAdd", [cc](const OpInputs& in) { return cc->EvalAdd(in.c1, in.c2); }},
+    {"EvalSub", [cc](const OpInputs& in) { return cc->EvalSub(in.c1, in.c2); }},
+    {"EvalMult (scalar)", [cc](const OpInputs& in) { return cc->EvalMult(in.c1, 4.0); }},
+    {"EvalMult (ciphertext)", [cc](const OpInputs& in) { return cc->EvalMult(in.c1, in.c2); }},
+    {"EvalMultNoRelin", [cc](const OpInputs& in) { return cc->EvalMultNoRelin(in.c1, in.c2); }},
+    {"Relinearize", [cc](const OpInputs& in) { return cc->Relinearize(in.cMulNoRelin); }},
+    {"EvalRotate (1)", [cc](const OpInputs& in) { return cc->EvalRotate(in.c1, 1); }},
+    {"EvalRotate (-2)", [cc](const OpInputs& in) { return cc->EvalRotate(in.c1, -2); }},
+    {"Decrypt", [cc, keys](const OpInputs& in) {
+       Plaintext result;
+       cc->Decrypt(keys.secretKey, in.c1, &result);
+       return Ciphertext<DCRTPoly>();
+     }},
+  };
+}
+
+size_t serializedSize(const Ciphertext<DCRTPoly>& ciphertext)
+{
+  std::ostringstream os;
+  Serial::Serialize(ciphertext, os, SerType::BINARY);
+  return os.str().size();
+}
+
+size_t serializedSize(const PublicKey<DCRTPoly>& publicKey)
+{
+  std::ostringstream os;
+  Serial::Serialize(publicKey, os, SerType::BINARY);
+  return os.str().size();
+}
+
+size_t serializedSize(const PrivateKey<DCRTPoly>& secretKey)
+{
+  std::ostringstream os;
+  Serial::Serialize(secretKey, os, SerType::BINARY);
+  return os.str().size();
+}
+
+size_t serializedEvalMultKeySize()
+{
+  std::ostringstream os;
+  CryptoContextImpl<DCRTPoly>::SerializeEvalMultKey(os, SerType::BINARY);
+  return os.str().size();
+}
+
+size_t serializedEvalAutomorphismKeySize()
+{
+  std::ostringstream os;
+  CryptoContextImpl<DCRTPoly>::SerializeEvalAutomorphismKey(os, SerType::BINARY);
+  return os.str().size();
+}
+
+ProfileData profileOp(const BenchOp& op, const OpInputs& inputs, const ProfileOptions& options)
+{
+  ProfileData profile = measureOperation(op.name, options, [&op, &inputs] { op.run(inputs); });
+  Ciphertext<DCRTPoly> output = op.run(inputs);
+  if (output) {
+    profile.outputBytes = serializedSize(output);
+  }
+  return profile;
+}
+
+void printSweepResults(const std::vector<SweepResult>& results) {
+  std::cout << "\n============ Parameter Sweep Results ============\n";
+  std::cout << std::left << std::setw(8) << "logN"
+            << std::right << std::setw(7) << "depth"
+            << std::right << std::setw(7) << "dq"
+            << std::right << std::setw(7) << "q0"
+            << std::right << std::setw(8) << "slots"
+            << "  " << std::left << std::setw(25) << "Operation"
+            << std::right << std::setw(15) << "First Run (ms)"
+            << std::right << std::setw(12) << "Mean (ms)"
+            << std::right << std::setw(12) << "Median (ms)"
+            << std::right << std::setw(12) << "P99 (ms)" << std::endl;
+  std::cout << std::string(113, '-') << std::endl;
+
+  for (const auto& result : results) {
+    const CKKSConfig& config = result.config;
+    for (const auto& profile : result.profiles) {
+      std::cout << std::left << std::setw(8) << static_cast<uint32_t>(std::log2(config.ringDim))
+                << std::right << std::setw(7) << config.multDepth
+                << std::right << std::setw(7) << config.scaleModSize
+                << std::right << std::setw(7) << config.firstModSize
+                << std::right << std::setw(8) << config.batchSize
+                << "  " << std::left << std::setw(25) << profile.operationName
+                << std::right << std::fixed << std::setprecision(3) << std::setw(15) << profile.firstRunTime
+                << std::right << std::fixed << std::setprecision(3) << std::setw(12) << profile.stats.mean
+                << std::right << std::fixed << std::setprecision(3) << std::setw(12) << profile.stats.median
+                << std::right << std::fixed << std::setprecision(3) << std::setw(12) << profile.stats.p99 << std::endl;
+    }
+  }
+  std::cout << std::string(113, '-') << std::endl;
+}
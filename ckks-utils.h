@@ -0,0 +1,97 @@
+#ifndef CKKS_UTILS_H
+#define CKKS_UTILS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils.h"
+#include "openfhe.h"
+
+// One point of the CKKS parameter grid.
+struct CKKSConfig {
+    uint32_t ringDim = (1 << 16);
+    uint32_t multDepth = 10;
+    uint32_t scaleModSize = 59;
+    uint32_t firstModSize = 60;
+    uint32_t batchSize = (1 << 15);
+    lbcrypto::KeySwitchTechnique keySwitchTechnique = lbcrypto::HYBRID;
+    // number of digits in HYBRID key switching (dnum); 0 lets OpenFHE choose
+    uint32_t numLargeDigits = 0;
+    // OpenFHE's CKKS default; FIXEDMANUAL is needed for explicit Rescale and LevelReduce
+    lbcrypto::ScalingTechnique scalingTechnique = lbcrypto::FLEXIBLEAUTOEXT;
+
+    std::string label() const;
+    // name/value pairs recorded with machine-readable results
+    std::vector<std::pair<std::string, std::string>> parameters() const;
+};
+
+// Builds the cartesian product of the grid options:
+//   --log-ring-dim   log2 of the ring dimension (default 16)
+//   --depth          multiplicative depth (default 10)
+//   --scale-mod      scaling modulus size in bits (default 59)
+//   --first-mod      first modulus size in bits (default 60)
+//   --log-batch      log2 of the batch size (default: ring dimension / 2)
+// Every option accepts lists and ranges, e.g. --log-ring-dim=12..17 --depth=5,10.
+// Points whose batch size exceeds ring dimension / 2 are dropped.
+std::vector<CKKSConfig> buildConfigGrid(const BenchArgs& args);
+
+const char* scalingTechniqueName(lbcrypto::ScalingTechnique technique);
+// Inverse of scalingTechniqueName; throws std::invalid_argument for unknown names.
+lbcrypto::ScalingTechnique scalingTechniqueFromName(const std::string& name);
+
+lbcrypto::CryptoContext<lbcrypto::DCRTPoly> makeCKKSContext(const CKKSConfig& config);
+
+void printModuliChain(const lbcrypto::DCRTPoly& poly);
+
+// Inputs shared by the add/mul operation list. Each set is encrypted
+// independently so that several sets can be processed concurrently.
+struct OpInputs {
+    std::vector<double> x1;
+    std::vector<double> x2;
+    lbcrypto::Plaintext ptxt1;
+    lbcrypto::Ciphertext<lbcrypto::DCRTPoly> c1;
+    lbcrypto::Ciphertext<lbcrypto::DCRTPoly> c2;
+    lbcrypto::Ciphertext<lbcrypto::DCRTPoly> cMulNoRelin;
+};
+
+OpInputs makeOpInputs(const lbcrypto::CryptoContext<lbcrypto::DCRTPoly>& cc,
+                      const lbcrypto::KeyPair<lbcrypto::DCRTPoly>& keys,
+                      uint32_t batchSize, uint32_t seed);
+
+// A named homomorphic operation. run() returns the resulting ciphertext,
+// or nullptr for operations producing a plaintext.
+struct BenchOp {
+    std::string name;
+    std::function<lbcrypto::Ciphertext<lbcrypto::DCRTPoly>(const OpInputs&)> run;
+};
+
+// Generates the keys needed by makeAddMulOps (relinearization and rotations by 1 and -2).
+lbcrypto::KeyPair<lbcrypto::DCRTPoly> generateAddMulKeys(const lbcrypto::CryptoContext<lbcrypto::DCRTPoly>& cc);
+
+// The operation list profiled by bench-add-mul.
+std::vector<BenchOp> makeAddMulOps(const lbcrypto::CryptoContext<lbcrypto::DCRTPoly>& cc,
+                                   const lbcrypto::KeyPair<lbcrypto::DCRTPoly>& keys);
+
+// Size of the binary serialization of an object, i.e. what it costs on the wire or on disk.
+size_t serializedSize(const lbcrypto::Ciphertext<lbcrypto::DCRTPoly>& ciphertext);
+size_t serializedSize(const lbcrypto::PublicKey<lbcrypto::DCRTPoly>& publicKey);
+size_t serializedSize(const lbcrypto::PrivateKey<lbcrypto::DCRTPoly>& secretKey);
+
+// Binary serialized size of all relinearization / rotation keys currently held by OpenFHE.
+size_t serializedEvalMultKeySize();
+size_t serializedEvalAutomorphismKeySize();
+
+// Profiles op and records the serialized size of the ciphertext it produces.
+ProfileData profileOp(const BenchOp& op, const OpInputs& inputs, const ProfileOptions& options);
+
+struct SweepResult {
+    CKKSConfig config;
+    std::vector<ProfileData> profiles;
+};
+
+void printSweepResults(const std::vector<SweepResult>& results);
+
+#endif  // CKKS_UTILS_H
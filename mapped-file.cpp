@@ -0,0 +1,55 @@
+#include "mapped-file.h"
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::streambuf::pos_type MemoryStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  if (!(which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+  }
+  char* target = (dir == std::ios_base::beg) ? eback() + off : (dir == std::ios_base::cur) ? gptr() + off : egptr() + off;
+  if (target < eback() || target > egptr()) {
+      return pos_type(off_type(-1));
+  }
+  setg(eback(), target, egptr());
+  return pos_type(target - eback());
+}
+
+std::streambuf::pos_type MemoryStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which) {
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+MappedFile::MappedFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+      throw std::runtime_error("Cannot open " + path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw std::runtime_error("Cannot stat " + path);
+  }
+  m_size = static_cast<size_t>(st.st_size);
+  if (m_size > 0) {
+      void* addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+          close(fd);
+          throw std::runtime_error("Cannot mmap " + path);
+      }
+      // deserialization reads front to back; advice values are not flags, so one call each.
+      // The advice is only a hint: where the kernel rejects it the mapping still works.
+      (void)madvise(addr, m_size, MADV_SEQUENTIAL);
+      (void)madvise(addr, m_size, MADV_WILLNEED);
+      m_data = static_cast<const char*>(addr);
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (m_data != nullptr) {
+      munmap(const_cast<char*>(m_data), m_size);
+  }
+}
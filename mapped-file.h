@@ -0,0 +1,45 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <streambuf>
+#include <string>
+
+// Read-only std::streambuf over memory owned by someone else. Lets OpenFHE's
+// stream-based deserializers read straight from a buffer without copying it
+// into a std::string or std::stringstream first.
+class MemoryStreamBuf : public std::streambuf {
+public:
+    MemoryStreamBuf(const char* data, size_t size) {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
+
+// A file mapped read-only into memory with mmap. Pages are faulted in from the
+// page cache on first access instead of being copied through read().
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const {
+        return m_data;
+    }
+    size_t size() const {
+        return m_size;
+    }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+#endif  // MAPPED_FILE_H
@@ -0,0 +1,128 @@
+#include "memory-stats.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+
+static std::atomic<uint64_t> g_allocations{0};
+static std::atomic<uint64_t> g_bytes{0};
+
+static void* countedAlloc(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_bytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* countedAlignedAlloc(std::size_t size, std::size_t alignment) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (alignment < sizeof(void*)) {
+      alignment = sizeof(void*);
+  }
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, alignment, size == 0 ? 1 : size) != 0) {
+      return nullptr;
+  }
+  return ptr;
+}
+
+void* operator new(std::size_t size) {
+  void* ptr = countedAlloc(size);
+  if (ptr == nullptr) {
+      throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  void* ptr = countedAlignedAlloc(size, static_cast<std::size_t>(alignment));
+  if (ptr == nullptr) {
+      throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+AllocCounters readAllocCounters() {
+  AllocCounters counters;
+  counters.allocations = g_allocations.load(std::memory_order_relaxed);
+  counters.bytes = g_bytes.load(std::memory_order_relaxed);
+  return counters;
+}
+
+static size_t readStatusField(const std::string& field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+      if (line.compare(0, field.size(), field) == 0 && line.size() > field.size() && line[field.size()] == ':') {
+          // "VmHWM:     123456 kB"
+          return std::strtoull(line.c_str() + field.size() + 1, nullptr, 10) * 1024;
+      }
+  }
+  return 0;
+}
+
+size_t readCurrentRSSBytes() {
+  return readStatusField("VmRSS");
+}
+
+size_t readPeakRSSBytes() {
+  return readStatusField("VmHWM");
+}
+
+bool resetPeakRSS() {
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  if (!clearRefs) {
+      return false;
+  }
+  clearRefs << "5";
+  return static_cast<bool>(clearRefs.flush());
+}
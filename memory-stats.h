@@ -0,0 +1,25 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Process-wide heap counters maintained by the global operator new/delete
+// replacements in memory-stats.cpp. Every benchmark target links that file,
+// so allocations made inside the OpenFHE shared libraries are counted too.
+struct AllocCounters {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+AllocCounters readAllocCounters();
+
+// Resident set size from /proc/self/status; 0 where unavailable.
+size_t readCurrentRSSBytes();
+size_t readPeakRSSBytes();
+
+// Resets the peak RSS (VmHWM) to the current RSS. Returns false if the kernel
+// does not support it, in which case peak deltas only show growth past the old peak.
+bool resetPeakRSS();
+
+#endif  // MEMORY_STATS_H
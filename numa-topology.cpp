@@ -0,0 +1,115 @@
+#include "numa-topology.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// From <numaif.h>, which is only installed with libnuma.
+static const int MPOL_BIND_MODE = 2;
+static const int MPOL_INTERLEAVE_MODE = 3;
+#endif
+
+std::vector<uint32_t> parseCpuList(const std::string& text) {
+  std::vector<uint32_t> cpus;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+      if (item.empty() || item == "\n") {
+          continue;
+      }
+      size_t dash = item.find('-');
+      uint32_t first = static_cast<uint32_t>(std::stoul(item.substr(0, dash)));
+      uint32_t last = dash == std::string::npos ? first : static_cast<uint32_t>(std::stoul(item.substr(dash + 1)));
+      for (uint32_t cpu = first; cpu <= last; ++cpu) {
+          cpus.push_back(cpu);
+      }
+  }
+  return cpus;
+}
+
+std::vector<NumaNode> readNumaTopology() {
+  std::vector<NumaNode> nodes;
+#ifdef __linux__
+  const std::string root = "/sys/devices/system/node";
+  if (DIR* dir = opendir(root.c_str())) {
+      while (dirent* entry = readdir(dir)) {
+          std::string name = entry->d_name;
+          if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+              !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+              continue;
+          }
+          std::ifstream cpulist(root + "/" + name + "/cpulist");
+          std::string text;
+          std::getline(cpulist, text);
+          NumaNode node;
+          node.id = static_cast<uint32_t>(std::stoul(name.substr(4)));
+          node.cpus = parseCpuList(text);
+          if (!node.cpus.empty()) {
+              nodes.push_back(node);
+          }
+      }
+      closedir(dir);
+  }
+#endif
+  if (nodes.empty()) {
+      NumaNode node;
+      for (uint32_t cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+          node.cpus.push_back(cpu);
+      }
+      nodes.push_back(node);
+  }
+  std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+  return nodes;
+}
+
+#ifdef __linux__
+
+bool pinProcessToCpus(const std::vector<uint32_t>& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (uint32_t cpu : cpus) {
+      CPU_SET(cpu, &set);
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+static bool setMemoryPolicy(int mode, const std::vector<uint32_t>& nodes) {
+  const unsigned long bitsPerWord = 8 * sizeof(unsigned long);
+  uint32_t maxNode = nodes.empty() ? 0 : *std::max_element(nodes.begin(), nodes.end());
+  std::vector<unsigned long> mask(maxNode / bitsPerWord + 1, 0);
+  for (uint32_t node : nodes) {
+      mask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+  }
+  // maxnode counts one bit past the highest node, as the kernel drops the last bit
+  return syscall(SYS_set_mempolicy, mode, mask.data(), mask.size() * bitsPerWord + 1) == 0;
+}
+
+bool bindMemoryToNodes(const std::vector<uint32_t>& nodes) {
+  return setMemoryPolicy(MPOL_BIND_MODE, nodes);
+}
+
+bool interleaveMemoryOverNodes(const std::vector<uint32_t>& nodes) {
+  return setMemoryPolicy(MPOL_INTERLEAVE_MODE, nodes);
+}
+
+#else
+
+bool pinProcessToCpus(const std::vector<uint32_t>&) {
+  return false;
+}
+
+bool bindMemoryToNodes(const std::vector<uint32_t>&) {
+  return false;
+}
+
+bool interleaveMemoryOverNodes(const std::vector<uint32_t>&) {
+  return false;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct NumaNode {
+    uint32_t id = 0;
+    std::vector<uint32_t> cpus;
+};
+
+// Nodes with at least one CPU, read from /sys/devices/system/node. Without
+// NUMA information (non-Linux, or a kernel without NUMA) a single node 0
+// holding every hardware thread is returned.
+std::vector<NumaNode> readNumaTopology();
+
+// Parses the kernel's CPU list format, e.g. "0-3,8,10-11".
+std::vector<uint32_t> parseCpuList(const std::string& text);
+
+// Restricts the calling process (and the threads it creates afterwards) to cpus.
+bool pinProcessToCpus(const std::vector<uint32_t>& cpus);
+
+// Sets the memory policy of the calling process through set_mempolicy: new pages
+// are taken only from nodes (bind) or spread round-robin over them (interleave).
+// Pages touched before the call keep their placement. Return false where the
+// kernel does not support memory policies.
+bool bindMemoryToNodes(const std::vector<uint32_t>& nodes);
+bool interleaveMemoryOverNodes(const std::vector<uint32_t>& nodes);
+
+#endif  // NUMA_TOPOLOGY_H
@@ -0,0 +1,95 @@
+#include "perf-counters.h"
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Order matches the fields of PerfCounts. PERF_COUNT_HW_CACHE_MISSES counts
+// last-level cache misses on current Intel and AMD cores.
+static const uint64_t eventConfigs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+static int openCounter(pid_t tid, uint64_t config) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+PerfCounters::PerfCounters() {
+  DIR* tasks = opendir("/proc/self/task");
+  if (tasks == nullptr) {
+      return;
+  }
+  while (dirent* entry = readdir(tasks)) {
+      if (entry->d_name[0] == '.') {
+          continue;
+      }
+      pid_t tid = static_cast<pid_t>(std::stoi(entry->d_name));
+      for (int event = 0; event < 4; ++event) {
+          int fd = openCounter(tid, eventConfigs[event]);
+          if (fd >= 0) {
+              m_counters.push_back({fd, event});
+          }
+      }
+  }
+  closedir(tasks);
+}
+
+PerfCounters::~PerfCounters() {
+  for (const auto& counter : m_counters) {
+      close(counter.fd);
+  }
+}
+
+void PerfCounters::start() {
+  for (const auto& counter : m_counters) {
+      ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+PerfCounts PerfCounters::stop() {
+  for (const auto& counter : m_counters) {
+      ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+  uint64_t totals[4] = {0, 0, 0, 0};
+  for (const auto& counter : m_counters) {
+      uint64_t values[3];  // value, time enabled, time running
+      if (read(counter.fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0) {
+          continue;
+      }
+      totals[counter.event] += static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+  }
+  PerfCounts counts;
+  counts.cycles = totals[0];
+  counts.instructions = totals[1];
+  counts.llcMisses = totals[2];
+  counts.branchMisses = totals[3];
+  return counts;
+}
+
+#else
+
+PerfCounters::PerfCounters() {}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+PerfCounts PerfCounters::stop() {
+  return PerfCounts();
+}
+
+#endif
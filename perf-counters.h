@@ -0,0 +1,45 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <vector>
+
+// Hardware event totals, scaled up when the kernel had to multiplex counters.
+struct PerfCounts {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llcMisses = 0;
+    uint64_t branchMisses = 0;
+};
+
+// User-space hardware counters for every thread of the process, read through
+// perf_event_open. Counters are opened per thread so that OpenMP workers
+// started before the measurement are included; threads created afterwards are not.
+// Where perf events are unavailable (non-Linux, containers, perf_event_paranoid > 2)
+// available() returns false and stop() returns zeros.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const {
+        return !m_counters.empty();
+    }
+
+    // Resets and enables every counter.
+    void start();
+    // Disables the counters and returns the totals since start().
+    PerfCounts stop();
+
+private:
+    struct Counter {
+        int fd;
+        int event;
+    };
+    std::vector<Counter> m_counters;
+};
+
+#endif  // PERF_COUNTERS_H
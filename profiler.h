@@ -0,0 +1,227 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "memory-stats.h"
+#include "perf-counters.h"
+
+// Controls how many times measureOperation runs an operation.
+// Warmup runs are timed (the first one is reported as firstRunTime) but excluded
+// from the statistics. After minRuns samples, sampling stops as soon as the 95%
+// confidence interval half-width drops below targetRelError * mean, or when
+// maxRuns samples or maxTimeMs of sampling is reached. targetRelError = 0 always
+// takes maxRuns samples.
+struct ProfileOptions {
+    uint32_t warmupRuns = 1;
+    uint32_t minRuns = 10;
+    uint32_t maxRuns = 100;
+    double targetRelError = 0.0;
+    double maxTimeMs = 0.0;
+    // samples further than outlierThreshold robust standard deviations (1.4826 * MAD)
+    // from the median are excluded from mean, stddev and confidence interval
+    double outlierThreshold = 5.0;
+    // read hardware counters (perf_event_open) over the timed runs
+    bool perfCounters = false;
+};
+
+// Order statistics are taken over all samples so the tail is never hidden;
+// mean, stddev and the confidence interval are taken over the non-outliers.
+struct RunStats {
+    uint32_t samples = 0;
+    uint32_t outliers = 0;
+    double min = 0;
+    double median = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+    double mean = 0;
+    double stddev = 0;
+    double ciLow = 0;
+    double ciHigh = 0;
+};
+
+struct ProfileData {
+    double firstRunTime = 0;
+    double avgTimeExcludingFirst = 0;
+    std::string operationName;
+    RunStats stats;
+    // heap allocations and bytes requested per timed run
+    double allocationsPerRun = 0;
+    double bytesAllocatedPerRun = 0;
+    // growth of the peak RSS over all runs, warmup included
+    int64_t peakRSSDeltaBytes = 0;
+    // serialized size of the operation's result; filled in by the caller, 0 if not applicable
+    size_t outputBytes = 0;
+    // aggregate throughput where jobs run concurrently; filled in by the caller, 0 if not applicable
+    double opsPerSecond = 0;
+    // hardware counters per timed run, summed over all threads; set when
+    // ProfileOptions::perfCounters is on and perf events are available
+    bool hasPerfCounters = false;
+    double cyclesPerRun = 0;
+    double instructionsPerRun = 0;
+    double llcMissesPerRun = 0;
+    double branchMissesPerRun = 0;
+};
+
+// Two-sided 95% Student t quantile.
+inline double tQuantile95(uint32_t degreesOfFreedom) {
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degreesOfFreedom == 0) {
+        return 0;
+    }
+    return degreesOfFreedom <= 30 ? table[degreesOfFreedom - 1] : 1.96;
+}
+
+// Linear-interpolated percentile of sorted data, p in [0, 1].
+inline double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    double pos = p * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(pos);
+    size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (pos - lower) * (sorted[upper] - sorted[lower]);
+}
+
+inline RunStats computeRunStats(std::vector<double> samples, double outlierThreshold) {
+    RunStats stats;
+    stats.samples = static_cast<uint32_t>(samples.size());
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    stats.min = samples.front();
+    stats.median = percentile(samples, 0.5);
+    stats.p90 = percentile(samples, 0.9);
+    stats.p99 = percentile(samples, 0.99);
+    stats.max = samples.back();
+
+    std::vector<double> deviations;
+    deviations.reserve(samples.size());
+    for (double s : samples) {
+        deviations.push_back(std::fabs(s - stats.median));
+    }
+    std::sort(deviations.begin(), deviations.end());
+    double robustSigma = 1.4826 * percentile(deviations, 0.5);
+
+    std::vector<double> kept;
+    kept.reserve(samples.size());
+    for (double s : samples) {
+        if (robustSigma == 0 || std::fabs(s - stats.median) <= outlierThreshold * robustSigma) {
+            kept.push_back(s);
+        }
+    }
+    stats.outliers = static_cast<uint32_t>(samples.size() - kept.size());
+
+    double sum = 0;
+    for (double s : kept) {
+        sum += s;
+    }
+    stats.mean = sum / kept.size();
+
+    double sq = 0;
+    for (double s : kept) {
+        sq += (s - stats.mean) * (s - stats.mean);
+    }
+    stats.stddev = (kept.size() > 1) ? std::sqrt(sq / (kept.size() - 1)) : 0;
+
+    double halfWidth = (kept.size() > 1) ? tQuantile95(static_cast<uint32_t>(kept.size() - 1)) * stats.stddev / std::sqrt(kept.size()) : 0;
+    stats.ciLow = stats.mean - halfWidth;
+    stats.ciHigh = stats.mean + halfWidth;
+    return stats;
+}
+
+// Times func() according to options and returns its statistics in milliseconds,
+// together with its heap allocation counts and peak RSS growth.
+// The return value of func is discarded after every run.
+template <typename F>
+ProfileData measureOperation(const std::string& opName, const ProfileOptions& options, F&& func) {
+    ProfileData profile;
+    profile.operationName = opName;
+
+    resetPeakRSS();
+    size_t rssBefore = readCurrentRSSBytes();
+
+    AllocCounters allocated;
+    auto timeOnce = [&func, &allocated]() {
+        AllocCounters before = readAllocCounters();
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        auto end = std::chrono::high_resolution_clock::now();
+        AllocCounters after = readAllocCounters();
+        allocated.allocations += after.allocations - before.allocations;
+        allocated.bytes += after.bytes - before.bytes;
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    for (uint32_t i = 0; i < options.warmupRuns; i++) {
+        double timeMs = timeOnce();
+        if (i == 0) {
+            profile.firstRunTime = timeMs;
+        }
+    }
+
+    allocated = AllocCounters();
+    // opened after the warmup so that lazily started worker threads already exist
+    std::unique_ptr<PerfCounters> counters;
+    if (options.perfCounters) {
+        counters = std::make_unique<PerfCounters>();
+        counters->start();
+    }
+    std::vector<double> runTimes;
+    runTimes.reserve(options.maxRuns);
+    double elapsedMs = 0;
+    while (runTimes.size() < options.maxRuns) {
+        double timeMs = timeOnce();
+        runTimes.push_back(timeMs);
+        elapsedMs += timeMs;
+
+        if (runTimes.size() < std::max<uint32_t>(options.minRuns, 2)) {
+            continue;
+        }
+        if (options.maxTimeMs > 0 && elapsedMs >= options.maxTimeMs) {
+            break;
+        }
+        if (options.targetRelError > 0) {
+            RunStats current = computeRunStats(runTimes, options.outlierThreshold);
+            if (current.ciHigh - current.mean <= options.targetRelError * current.mean) {
+                break;
+            }
+        }
+    }
+
+    if (counters && counters->available() && !runTimes.empty()) {
+        PerfCounts counts = counters->stop();
+        double runs = static_cast<double>(runTimes.size());
+        profile.hasPerfCounters = true;
+        profile.cyclesPerRun = counts.cycles / runs;
+        profile.instructionsPerRun = counts.instructions / runs;
+        profile.llcMissesPerRun = counts.llcMisses / runs;
+        profile.branchMissesPerRun = counts.branchMisses / runs;
+    }
+
+    if (options.warmupRuns == 0 && !runTimes.empty()) {
+        profile.firstRunTime = runTimes.front();
+    }
+    profile.stats = computeRunStats(runTimes, options.outlierThreshold);
+    profile.avgTimeExcludingFirst = profile.stats.mean;
+    if (!runTimes.empty()) {
+        profile.allocationsPerRun = static_cast<double>(allocated.allocations) / runTimes.size();
+        profile.bytesAllocatedPerRun = static_cast<double>(allocated.bytes) / runTimes.size();
+    }
+    profile.peakRSSDeltaBytes = static_cast<int64_t>(readPeakRSSBytes()) - static_cast<int64_t>(rssBefore);
+    return profile;
+}
+
+#endif  // PROFILER_H
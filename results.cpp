@@ -0,0 +1,228 @@
+#include "results.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifndef BENCH_OPENFHE_VERSION
+#define BENCH_OPENFHE_VERSION "unknown"
+#endif
+#ifndef BENCH_CXX_FLAGS
+#define BENCH_CXX_FLAGS "unknown"
+#endif
+
+static std::string cpuModel() {
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+      if (line.rfind("model name", 0) == 0) {
+          size_t colon = line.find(':');
+          if (colon != std::string::npos) {
+              return line.substr(line.find_first_not_of(' ', colon + 1));
+          }
+      }
+  }
+  return "unknown";
+}
+
+static std::string compilerVersion() {
+#if defined(__clang__)
+  return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+  return std::string("gcc ") + __VERSION__;
+#else
+  return "unknown";
+#endif
+}
+
+static std::string timestamp() {
+  std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::ostringstream ss;
+  ss << std::put_time(std::gmtime(&now), "%Y-%m-%dT%H:%M:%SZ");
+  return ss.str();
+}
+
+ParameterList collectMetadata(const std::string& benchmark) {
+  return {
+      {"benchmark", benchmark},
+      {"timestamp", timestamp()},
+      {"openfhe_version", BENCH_OPENFHE_VERSION},
+      {"cpu_model", cpuModel()},
+      {"hardware_threads", std::to_string(std::thread::hardware_concurrency())},
+      {"openmp_threads", std::to_string(currentIntraOpThreads())},
+      {"compiler", compilerVersion()},
+      {"cxx_flags", BENCH_CXX_FLAGS},
+  };
+}
+
+static std::string jsonEscape(const std::string& text) {
+  std::ostringstream ss;
+  for (char c : text) {
+      switch (c) {
+          case '"': ss << "\\\""; break;
+          case '\\': ss << "\\\\"; break;
+          case '\n': ss << "\\n"; break;
+          case '\t': ss << "\\t"; break;
+          default:
+              if (static_cast<unsigned char>(c) < 0x20) {
+                  ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+              }
+              else {
+                  ss << c;
+              }
+      }
+  }
+  return ss.str();
+}
+
+static std::string csvEscape(const std::string& text) {
+  if (text.find_first_of(",\"\n") == std::string::npos) {
+      return text;
+  }
+  std::string quoted = "\"";
+  for (char c : text) {
+      if (c == '"') {
+          quoted += '"';
+      }
+      quoted += c;
+  }
+  return quoted + "\"";
+}
+
+// Column names and values of one profile, shared by the JSON and CSV writers.
+static ParameterList profileFields(const ProfileData& profile) {
+  auto num = [](double value) {
+      std::ostringstream ss;
+      ss << std::setprecision(9) << value;
+      return ss.str();
+  };
+  const RunStats& stats = profile.stats;
+  return {
+      {"operation", profile.operationName},
+      {"samples", std::to_string(stats.samples)},
+      {"outliers", std::to_string(stats.outliers)},
+      {"first_run_ms", num(profile.firstRunTime)},
+      {"mean_ms", num(stats.mean)},
+      {"stddev_ms", num(stats.stddev)},
+      {"ci_low_ms", num(stats.ciLow)},
+      {"ci_high_ms", num(stats.ciHigh)},
+      {"min_ms", num(stats.min)},
+      {"median_ms", num(stats.median)},
+      {"p90_ms", num(stats.p90)},
+      {"p99_ms", num(stats.p99)},
+      {"max_ms", num(stats.max)},
+      {"allocs_per_run", num(profile.allocationsPerRun)},
+      {"alloc_bytes_per_run", num(profile.bytesAllocatedPerRun)},
+      {"peak_rss_delta_bytes", std::to_string(profile.peakRSSDeltaBytes)},
+      {"output_bytes", std::to_string(profile.outputBytes)},
+      {"ops_per_sec", num(profile.opsPerSecond)},
+      {"cycles_per_run", num(profile.cyclesPerRun)},
+      {"instructions_per_run", num(profile.instructionsPerRun)},
+      {"llc_misses_per_run", num(profile.llcMissesPerRun)},
+      {"branch_misses_per_run", num(profile.branchMissesPerRun)},
+  };
+}
+
+void writeResultsJSON(const std::string& path, const std::string& benchmark, const std::vector<ResultSet>& results) {
+  std::ofstream out(path);
+  if (!out) {
+      throw std::runtime_error("Cannot write results file: " + path);
+  }
+
+  out << "{\n  \"metadata\": {";
+  const ParameterList metadata = collectMetadata(benchmark);
+  for (size_t i = 0; i < metadata.size(); ++i) {
+      out << (i ? "," : "") << "\n    \"" << metadata[i].first << "\": \"" << jsonEscape(metadata[i].second) << "\"";
+  }
+  out << "\n  },\n  \"results\": [";
+
+  bool firstRow = true;
+  for (const auto& set : results) {
+      for (const auto& profile : set.profiles) {
+          out << (firstRow ? "" : ",") << "\n    {\n      \"parameters\": {";
+          firstRow = false;
+          for (size_t i = 0; i < set.parameters.size(); ++i) {
+              out << (i ? ", " : "") << "\"" << jsonEscape(set.parameters[i].first) << "\": \"" << jsonEscape(set.parameters[i].second) << "\"";
+          }
+          out << "}";
+          for (const auto& field : profileFields(profile)) {
+              bool isString = field.first == "operation";
+              out << ",\n      \"" << field.first << "\": "
+                  << (isString ? "\"" + jsonEscape(field.second) + "\"" : field.second);
+          }
+          out << "\n    }";
+      }
+  }
+  out << "\n  ]\n}\n";
+}
+
+void writeResultsCSV(const std::string& path, const std::string& benchmark, const std::vector<ResultSet>& results) {
+  std::ofstream out(path);
+  if (!out) {
+      throw std::runtime_error("Cannot write results file: " + path);
+  }
+
+  // metadata goes into leading comment lines so the table itself stays rectangular
+  for (const auto& entry : collectMetadata(benchmark)) {
+      out << "# " << entry.first << ": " << entry.second << "\n";
+  }
+
+  // result sets may carry different parameters (e.g. extra columns in one mode);
+  // the header is their union in first-seen order and missing cells stay empty
+  std::vector<std::string> columns;
+  for (const auto& set : results) {
+      for (const auto& param : set.parameters) {
+          if (std::find(columns.begin(), columns.end(), param.first) == columns.end()) {
+              columns.push_back(param.first);
+          }
+      }
+  }
+
+  bool headerWritten = false;
+  for (const auto& set : results) {
+      for (const auto& profile : set.profiles) {
+          ParameterList fields = profileFields(profile);
+          if (!headerWritten) {
+              bool first = true;
+              for (const auto& column : columns) {
+                  out << (first ? "" : ",") << csvEscape(column);
+                  first = false;
+              }
+              for (const auto& field : fields) {
+                  out << (first ? "" : ",") << field.first;
+                  first = false;
+              }
+              out << "\n";
+              headerWritten = true;
+          }
+          bool first = true;
+          for (const auto& column : columns) {
+              auto it = std::find_if(set.parameters.begin(), set.parameters.end(),
+                                     [&column](const std::pair<std::string, std::string>& param) { return param.first == column; });
+              out << (first ? "" : ",") << (it != set.parameters.end() ? csvEscape(it->second) : "");
+              first = false;
+          }
+          for (const auto& field : fields) {
+              out << (first ? "" : ",") << csvEscape(field.second);
+              first = false;
+          }
+          out << "\n";
+      }
+  }
+}
+
+void writeResults(const BenchArgs& args, const std::string& benchmark, const std::vector<ResultSet>& results) {
+  if (args.has("json")) {
+      writeResultsJSON(args.get("json", ""), benchmark, results);
+      std::cout << "Results written to " << args.get("json", "") << std::endl;
+  }
+  if (args.has("csv")) {
+      writeResultsCSV(args.get("csv", ""), benchmark, results);
+      std::cout << "Results written to " << args.get("csv", "") << std::endl;
+  }
+}
@@ -0,0 +1,29 @@
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils.h"
+
+using ParameterList = std::vector<std::pair<std::string, std::string>>;
+
+// Profiles measured under one parameter set.
+struct ResultSet {
+    ParameterList parameters;
+    std::vector<ProfileData> profiles;
+};
+
+// Writes the results to the files named by --json and --csv, if given.
+// Both files carry the benchmark name, OpenFHE version, CPU model, compiler,
+// compiler flags and thread counts next to the full parameter set of every row.
+void writeResults(const BenchArgs& args, const std::string& benchmark, const std::vector<ResultSet>& results);
+
+void writeResultsJSON(const std::string& path, const std::string& benchmark, const std::vector<ResultSet>& results);
+void writeResultsCSV(const std::string& path, const std::string& benchmark, const std::vector<ResultSet>& results);
+
+// Environment description shared by both formats, in a fixed order.
+ParameterList collectMetadata(const std::string& benchmark);
+
+#endif  // RESULTS_H
@@ -0,0 +1,164 @@
+#include "simd-kernels.h"
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+static void addGeneric(const double* a, const double* b, double* out, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] + b[i];
+  }
+}
+
+static void subtractGeneric(const double* a, const double* b, double* out, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] - b[i];
+  }
+}
+
+static void multiplyGeneric(const double* a, const double* b, double* out, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] * b[i];
+  }
+}
+
+static void scaleGeneric(const double* a, double scalar, double* out, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] * scalar;
+  }
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// Unaligned loads and stores: std::vector only guarantees 16-byte alignment,
+// and on current cores unaligned access to aligned data costs nothing extra.
+// Tails shorter than one register fall back to the generic kernels.
+
+__attribute__((target("avx2"))) static void addAVX2(const double* a, const double* b, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+      _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+  }
+  addGeneric(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void subtractAVX2(const double* a, const double* b, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+      _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+  }
+  subtractGeneric(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void multiplyAVX2(const double* a, const double* b, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+      _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+  }
+  multiplyGeneric(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void scaleAVX2(const double* a, double scalar, double* out, size_t n) {
+  const __m256d s = _mm256_set1_pd(scalar);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+      _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), s));
+  }
+  scaleGeneric(a + i, scalar, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void addAVX512(const double* a, const double* b, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+      _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+  }
+  addGeneric(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void subtractAVX512(const double* a, const double* b, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+      _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+  }
+  subtractGeneric(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void multiplyAVX512(const double* a, const double* b, double* out, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+      _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+  }
+  multiplyGeneric(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void scaleAVX512(const double* a, double scalar, double* out, size_t n) {
+  const __m512d s = _mm512_set1_pd(scalar);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+      _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), s));
+  }
+  scaleGeneric(a + i, scalar, out + i, n - i);
+}
+
+#endif  // SIMD_KERNELS_X86
+
+static const SimdKernels genericKernels = {SimdLevel::Generic, addGeneric, subtractGeneric, multiplyGeneric, scaleGeneric};
+#ifdef SIMD_KERNELS_X86
+static const SimdKernels avx2Kernels = {SimdLevel::AVX2, addAVX2, subtractAVX2, multiplyAVX2, scaleAVX2};
+static const SimdKernels avx512Kernels = {SimdLevel::AVX512, addAVX512, subtractAVX512, multiplyAVX512, scaleAVX512};
+#endif
+
+const char* simdLevelName(SimdLevel level) {
+  switch (level) {
+      case SimdLevel::AVX2:
+          return "AVX2";
+      case SimdLevel::AVX512:
+          return "AVX-512";
+      default:
+          return "generic";
+  }
+}
+
+std::vector<SimdLevel> supportedSimdLevels() {
+  std::vector<SimdLevel> levels = {SimdLevel::Generic};
+#ifdef SIMD_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+      levels.push_back(SimdLevel::AVX2);
+  }
+  if (__builtin_cpu_supports("avx512f")) {
+      levels.push_back(SimdLevel::AVX512);
+  }
+#endif
+  return levels;
+}
+
+SimdLevel detectSimdLevel() {
+  return supportedSimdLevels().back();
+}
+
+const SimdKernels& simdKernels(SimdLevel level) {
+  for (SimdLevel supported : supportedSimdLevels()) {
+      if (supported != level) {
+          continue;
+      }
+#ifdef SIMD_KERNELS_X86
+      if (level == SimdLevel::AVX2) {
+          return avx2Kernels;
+      }
+      if (level == SimdLevel::AVX512) {
+          return avx512Kernels;
+      }
+#endif
+      return genericKernels;
+  }
+  throw std::invalid_argument(std::string("SIMD level not supported by this CPU: ") + simdLevelName(level));
+}
+
+const SimdKernels& simdKernels() {
+  static const SimdKernels& best = simdKernels(detectSimdLevel());
+  return best;
+}
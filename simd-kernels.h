@@ -0,0 +1,37 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+#include <vector>
+
+// Instruction sets the plaintext kernels are compiled for. Every level is
+// built into the binary; the one used at run time is picked from the CPU.
+// Generic kernels are plain loops, vectorized only as far as the compiler's
+// baseline target (SSE2 on x86-64 without -march) allows.
+enum class SimdLevel { Generic, AVX2, AVX512 };
+
+const char* simdLevelName(SimdLevel level);
+
+// Best level supported by the running CPU.
+SimdLevel detectSimdLevel();
+
+// Every level the running CPU supports, Generic first.
+std::vector<SimdLevel> supportedSimdLevels();
+
+// Element-wise kernels over n doubles writing to out, which may alias a or b.
+// They never allocate.
+struct SimdKernels {
+    SimdLevel level;
+    void (*add)(const double* a, const double* b, double* out, size_t n);
+    void (*subtract)(const double* a, const double* b, double* out, size_t n);
+    void (*multiply)(const double* a, const double* b, double* out, size_t n);
+    void (*scale)(const double* a, double scalar, double* out, size_t n);
+};
+
+// Kernels of one level; the level must be supported by the CPU.
+const SimdKernels& simdKernels(SimdLevel level);
+
+// Kernels of detectSimdLevel(), resolved once.
+const SimdKernels& simdKernels();
+
+#endif  // SIMD_KERNELS_H
@@ -0,0 +1,140 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool with one task deque per worker. Tasks are spread
+// round-robin over the deques; a worker pops from the back of its own deque
+// and, when that is empty, steals from the front of the other workers' deques.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t numThreads) : m_queues(numThreads) {
+        for (auto& queue : m_queues) {
+            queue = std::make_unique<TaskQueue>();
+        }
+        m_workers.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i) {
+            m_workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_taskAvailable.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const {
+        return m_workers.size();
+    }
+
+    void submit(std::function<void()> task) {
+        size_t target = m_nextQueue.fetch_add(1) % m_queues.size();
+        m_pending.fetch_add(1);
+        // count the task before it becomes visible so a worker never decrements first
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_queued;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queues[target]->mutex);
+            m_queues[target]->tasks.push_back(std::move(task));
+        }
+        m_taskAvailable.notify_one();
+    }
+
+    // Blocks until every submitted task has finished.
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_allDone.wait(lock, [this] { return m_pending.load() == 0; });
+    }
+
+    // Number of tasks executed by a worker other than the one they were queued on.
+    size_t stealCount() const {
+        return m_steals.load();
+    }
+
+private:
+    struct TaskQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    bool popLocal(size_t index, std::function<void()>& task) {
+        TaskQueue& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t index, std::function<void()>& task) {
+        for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+            TaskQueue& queue = *m_queues[(index + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                m_steals.fetch_add(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        while (true) {
+            std::function<void()> task;
+            if (popLocal(index, task) || steal(index, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    --m_queued;
+                }
+                task();
+                if (m_pending.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_allDone.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this] { return m_stop || m_queued > 0; });
+            if (m_stop && m_queued == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_allDone;
+    size_t m_queued = 0;
+    bool m_stop = false;
+    std::atomic<size_t> m_pending{0};
+    std::atomic<size_t> m_nextQueue{0};
+    std::atomic<size_t> m_steals{0};
+};
+
+#endif  // THREAD_POOL_H
@@ -1,9 +1,24 @@
 #include "utils.h"
+#include "simd-kernels.h"
 #include <random>
 #include <cstdint>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 using namespace std::chrono;
@@ -23,62 +38,78 @@ std::vector<double> generateRandomDoubleVector(size_t size, uint32_t seed)
   return x;
 }
 
-using TimePoint = std::chrono::high_resolution_clock::time_point;
-
-template<typename F, typename... Args>
-ProfileData measureOperation(const std::string& opName, uint32_t numRuns, F&& func, Args&&... args) {
-    ProfileData profile;
-    profile.operationName = opName;
-    
-    if (numRuns == 0) {
-        profile.firstRunTime = 0;
-        profile.avgTimeExcludingFirst = 0;
-        return profile;
-    }
-    
-    std::vector<double> runTimes;
-    runTimes.reserve(numRuns);
-    
-    for (uint32_t i = 0; i < numRuns; i++) {
-        auto start = std::chrono::high_resolution_clock::now();
-        auto result = func(std::forward<Args>(args)...);
-        auto end = std::chrono::high_resolution_clock::now();
-        
-        double timeMs = std::chrono::duration<double, std::milli>(end - start).count();
-        runTimes.push_back(timeMs);
-        
-        if (i == numRuns - 1) {
-            return result;
-        }
-    }
-    
-    profile.firstRunTime = runTimes[0];
-    
-    double sum = 0;
-    for (uint32_t i = 1; i < numRuns; i++) {
-        sum += runTimes[i];
-    }
-    
-    profile.avgTimeExcludingFirst = (numRuns > 1) ? sum / (numRuns - 1) : 0;
-    return profile;
-}
-
 void printProfileResults(const std::vector<ProfileData>& profiles) {
     std::cout << "\n============ Performance Profiling Results ============\n";
     std::cout << std::left << std::setw(25) << "Operation"
+              << std::right << std::setw(7) << "Runs"
               << std::right << std::setw(15) << "First Run (ms)"
-              << std::right << std::setw(25) << "Avg (excl. first) (ms)"
-              << std::right << std::setw(20) << "Memory Overhead (ms)" << std::endl;
-    std::cout << std::string(85, '-') << std::endl;
-    
+              << std::right << std::setw(12) << "Mean (ms)"
+              << std::right << std::setw(12) << "Min (ms)"
+              << std::right << std::setw(12) << "Median (ms)"
+              << std::right << std::setw(12) << "P90 (ms)"
+              << std::right << std::setw(12) << "P99 (ms)"
+              << std::right << std::setw(12) << "Max (ms)"
+              << std::right << std::setw(12) << "Stddev (ms)"
+              << std::right << std::setw(24) << "95% CI (ms)"
+              << std::right << std::setw(13) << "Allocs/run"
+              << std::right << std::setw(15) << "Alloc MB/run"
+              << std::right << std::setw(17) << "Peak RSS +(MB)"
+              << std::right << std::setw(13) << "Output (KB)";
+    bool withPerf = std::any_of(profiles.begin(), profiles.end(), [](const ProfileData& p) { return p.hasPerfCounters; });
+    size_t width = 223;
+    if (withPerf) {
+        std::cout << std::right << std::setw(14) << "Mcycles/run"
+                  << std::right << std::setw(14) << "Minstr/run"
+                  << std::right << std::setw(7) << "IPC"
+                  << std::right << std::setw(16) << "LLC miss/run"
+                  << std::right << std::setw(16) << "Br. miss/run"
+                  << std::right << std::setw(14) << "Est. GB/s";
+        width += 81;
+    }
+    std::cout << std::endl;
+    std::cout << std::string(width, '-') << std::endl;
+
     for (const auto& profile : profiles) {
-        double memoryOverhead = profile.firstRunTime - profile.avgTimeExcludingFirst;
+        const RunStats& stats = profile.stats;
+        std::ostringstream ci;
+        ci << std::fixed << std::setprecision(3) << "[" << stats.ciLow << ", " << stats.ciHigh << "]";
         std::cout << std::left << std::setw(25) << profile.operationName
+                  << std::right << std::setw(7) << stats.samples
                   << std::right << std::fixed << std::setprecision(3) << std::setw(15) << profile.firstRunTime
-                  << std::right << std::fixed << std::setprecision(3) << std::setw(25) << profile.avgTimeExcludingFirst
-                  << std::right << std::fixed << std::setprecision(3) << std::setw(20) << memoryOverhead << std::endl;
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << stats.mean
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << stats.min
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << stats.median
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << stats.p90
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << stats.p99
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << stats.max
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(12) << stats.stddev
+                  << std::right << std::setw(24) << ci.str()
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(13) << profile.allocationsPerRun
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(15) << profile.bytesAllocatedPerRun / (1 << 20)
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(17) << static_cast<double>(profile.peakRSSDeltaBytes) / (1 << 20);
+        if (profile.outputBytes > 0) {
+            std::cout << std::right << std::fixed << std::setprecision(1) << std::setw(13) << profile.outputBytes / 1024.0;
+        }
+        else {
+            std::cout << std::right << std::setw(13) << "-";
+        }
+        if (withPerf && profile.hasPerfCounters) {
+            // every LLC miss moves one 64-byte line from DRAM; prefetches and writebacks are not seen
+            double bandwidth = stats.mean > 0 ? profile.llcMissesPerRun * 64 / (stats.mean * 1e6) : 0;
+            std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(14) << profile.cyclesPerRun / 1e6
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(14) << profile.instructionsPerRun / 1e6
+                      << std::right << std::fixed << std::setprecision(2) << std::setw(7)
+                      << (profile.cyclesPerRun > 0 ? profile.instructionsPerRun / profile.cyclesPerRun : 0)
+                      << std::right << std::fixed << std::setprecision(0) << std::setw(16) << profile.llcMissesPerRun
+                      << std::right << std::fixed << std::setprecision(0) << std::setw(16) << profile.branchMissesPerRun
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(14) << bandwidth;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::string(width, '-') << std::endl;
+    if (withPerf) {
+        std::cout << "Est. GB/s counts 64 bytes per LLC miss; it is a lower bound on DRAM traffic." << std::endl;
     }
-    std::cout << std::string(85, '-') << std::endl;
 }
 
 std::vector<double> pointwiseAdd(const std::vector<double>& v1, const std::vector<double>& v2) {
@@ -122,6 +153,145 @@ std::vector<double> scalarMultiply(const std::vector<double>& v, double scalar)
   return result;
 }
 
+static void checkSizes(size_t inputSize, size_t otherSize, size_t outputSize) {
+  if (inputSize != otherSize || inputSize != outputSize) {
+      throw std::invalid_argument("Vectors must have the same size.");
+  }
+}
+
+void pointwiseAdd(const std::vector<double>& v1, const std::vector<double>& v2, std::vector<double>& out) {
+  checkSizes(v1.size(), v2.size(), out.size());
+  simdKernels().add(v1.data(), v2.data(), out.data(), out.size());
+}
+
+void pointwiseSubtract(const std::vector<double>& v1, const std::vector<double>& v2, std::vector<double>& out) {
+  checkSizes(v1.size(), v2.size(), out.size());
+  simdKernels().subtract(v1.data(), v2.data(), out.data(), out.size());
+}
+
+void pointwiseMultiply(const std::vector<double>& v1, const std::vector<double>& v2, std::vector<double>& out) {
+  checkSizes(v1.size(), v2.size(), out.size());
+  simdKernels().multiply(v1.data(), v2.data(), out.data(), out.size());
+}
+
+void scalarMultiply(const std::vector<double>& v, double scalar, std::vector<double>& out) {
+  checkSizes(v.size(), v.size(), out.size());
+  simdKernels().scale(v.data(), scalar, out.data(), out.size());
+}
+
+std::vector<uint32_t> defaultThreadCounts(uint32_t maxThreads) {
+  std::vector<uint32_t> counts;
+  for (uint32_t t = 1; t < maxThreads; t *= 2) {
+      counts.push_back(t);
+  }
+  counts.push_back(maxThreads == 0 ? 1 : maxThreads);
+  return counts;
+}
+
+void printThreadingInfo() {
+#ifdef _OPENMP
+  std::cout << "\n\nNote this build is MULTI-THREADED (OpenMP, " << maxIntraOpThreads() << " threads) \n\n";
+#else
+  std::cout << "\n\nNote this build is SINGLE-THREADED \n\n";
+#endif
+}
+
+uint32_t maxIntraOpThreads() {
+#ifdef _OPENMP
+  return static_cast<uint32_t>(omp_get_num_procs());
+#else
+  return 1;
+#endif
+}
+
+uint32_t currentIntraOpThreads() {
+#ifdef _OPENMP
+  return static_cast<uint32_t>(omp_get_max_threads());
+#else
+  return 1;
+#endif
+}
+
+void setIntraOpThreads(uint32_t numThreads) {
+#ifdef _OPENMP
+  omp_set_num_threads(static_cast<int>(numThreads));
+#else
+  (void)numThreads;
+#endif
+}
+
+void pinIntraOpThreads(uint32_t numThreads) {
+#if defined(_OPENMP) && defined(__linux__)
+  if (std::getenv("OMP_PROC_BIND") != nullptr) {
+      return;
+  }
+  uint32_t numCores = std::max(1u, std::thread::hardware_concurrency());
+  // libgomp keeps its worker threads alive between parallel regions, so the
+  // affinity set here sticks for the regions run inside OpenFHE
+  #pragma omp parallel num_threads(numThreads)
+  {
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET(omp_get_thread_num() % numCores, &cpus);
+      pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  }
+#else
+  (void)numThreads;
+#endif
+}
+
+IntraOpAffinity saveIntraOpAffinity(uint32_t numThreads) {
+  IntraOpAffinity affinity;
+#if defined(_OPENMP) && defined(__linux__)
+  affinity.assign(numThreads, std::vector<unsigned char>(sizeof(cpu_set_t)));
+  #pragma omp parallel num_threads(numThreads)
+  {
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+      std::memcpy(affinity[omp_get_thread_num()].data(), &cpus, sizeof(cpus));
+  }
+#else
+  (void)numThreads;
+#endif
+  return affinity;
+}
+
+void restoreIntraOpAffinity(const IntraOpAffinity& affinity) {
+#if defined(_OPENMP) && defined(__linux__)
+  if (affinity.empty()) {
+      return;
+  }
+  #pragma omp parallel num_threads(static_cast<int>(affinity.size()))
+  {
+      cpu_set_t cpus;
+      std::memcpy(&cpus, affinity[omp_get_thread_num()].data(), sizeof(cpus));
+      pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  }
+#else
+  (void)affinity;
+#endif
+}
+
+void printScalingResults(const std::vector<ScalingRow>& rows) {
+    std::cout << "\n============ Thread Scaling Results ============\n";
+    std::cout << std::left << std::setw(25) << "Operation"
+              << std::right << std::setw(10) << "Threads"
+              << std::right << std::setw(15) << "Latency (ms)"
+              << std::right << std::setw(12) << "Speedup"
+              << std::right << std::setw(15) << "Efficiency" << std::endl;
+    std::cout << std::string(77, '-') << std::endl;
+
+    for (const auto& row : rows) {
+        std::cout << std::left << std::setw(25) << row.operationName
+                  << std::right << std::setw(10) << row.threads
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(15) << row.latencyMs
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(12) << row.speedup
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(14) << 100 * row.efficiency << "%" << std::endl;
+    }
+    std::cout << std::string(77, '-') << std::endl;
+}
+
 void printDoubleVector(const std::vector<double>& vec, const std::string& label, size_t numElements) {
   std::cout << label << ": [";
 
@@ -135,4 +305,162 @@ void printDoubleVector(const std::vector<double>& vec, const std::string& label,
   }
 
   std::cout << "]" << std::endl;
+}
+
+bool BenchArgs::has(const std::string& key) const {
+  return values.find(key) != values.end();
+}
+
+std::string BenchArgs::get(const std::string& key, const std::string& defaultValue) const {
+  auto it = values.find(key);
+  return (it == values.end()) ? defaultValue : it->second;
+}
+
+uint32_t BenchArgs::getUInt(const std::string& key, uint32_t defaultValue) const {
+  auto it = values.find(key);
+  return (it == values.end()) ? defaultValue : static_cast<uint32_t>(std::stoul(it->second));
+}
+
+std::vector<uint32_t> BenchArgs::getUIntList(const std::string& key, const std::vector<uint32_t>& defaultValue) const {
+  auto it = values.find(key);
+  return (it == values.end()) ? defaultValue : parseUIntList(it->second);
+}
+
+ProfileOptions profileOptionsFromArgs(const BenchArgs& args, const ProfileOptions& defaults) {
+  ProfileOptions options = defaults;
+  options.warmupRuns = args.getUInt("warmup", defaults.warmupRuns);
+  options.minRuns = args.getUInt("min-runs", defaults.minRuns);
+  options.maxRuns = args.getUInt("runs", defaults.maxRuns);
+  options.targetRelError = std::stod(args.get("rel-error", std::to_string(defaults.targetRelError)));
+  options.maxTimeMs = std::stod(args.get("max-time-ms", std::to_string(defaults.maxTimeMs)));
+  options.perfCounters = defaults.perfCounters || args.has("perf");
+  return options;
+}
+
+std::vector<std::string> BenchArgs::getList(const std::string& key, const std::vector<std::string>& defaultValue) const {
+  auto it = values.find(key);
+  if (it == values.end()) {
+      return defaultValue;
+  }
+  std::vector<std::string> items;
+  std::stringstream ss(it->second);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+      items.push_back(item);
+  }
+  return items;
+}
+
+static std::string trim(const std::string& text) {
+  size_t begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+      return "";
+  }
+  size_t end = text.find_last_not_of(" \t\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+BenchArgs parseArgs(int argc, char* argv[]) {
+  BenchArgs args;
+  for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (arg.rfind("--", 0) != 0) {
+          throw std::invalid_argument("Unexpected argument: " + arg);
+      }
+      arg = arg.substr(2);
+      size_t eq = arg.find('=');
+      if (eq != std::string::npos) {
+          args.values[arg.substr(0, eq)] = arg.substr(eq + 1);
+      }
+      else if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+          args.values[arg] = argv[++i];
+      }
+      else {
+          args.values[arg] = "";
+      }
+  }
+
+  if (args.has("config")) {
+      loadConfigFile(args, args.get("config", ""));
+  }
+  return args;
+}
+
+void loadConfigFile(BenchArgs& args, const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+      throw std::invalid_argument("Cannot open config file: " + path);
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+      line = trim(line.substr(0, line.find('#')));
+      if (line.empty()) {
+          continue;
+      }
+      size_t eq = line.find('=');
+      if (eq == std::string::npos) {
+          throw std::invalid_argument("Malformed config line: " + line);
+      }
+      // emplace keeps any value already given on the command line
+      args.values.emplace(trim(line.substr(0, eq)), trim(line.substr(eq + 1)));
+  }
+}
+
+std::vector<std::string> splitCSVLine(const std::string& line) {
+  std::vector<std::string> fields;
+  std::string field;
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+      char c = line[i];
+      if (quoted) {
+          if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+              field += '"';
+              ++i;
+          }
+          else if (c == '"') {
+              quoted = false;
+          }
+          else {
+              field += c;
+          }
+      }
+      else if (c == '"') {
+          quoted = true;
+      }
+      else if (c == ',') {
+          fields.push_back(field);
+          field.clear();
+      }
+      else {
+          field += c;
+      }
+  }
+  fields.push_back(field);
+  return fields;
+}
+
+std::vector<uint32_t> parseUIntList(const std::string& text) {
+  std::vector<uint32_t> result;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+      item = trim(item);
+      if (item.empty()) {
+          continue;
+      }
+      size_t dots = item.find("..");
+      if (dots == std::string::npos) {
+          result.push_back(static_cast<uint32_t>(std::stoul(item)));
+          continue;
+      }
+      uint32_t first = static_cast<uint32_t>(std::stoul(item.substr(0, dots)));
+      uint32_t last = static_cast<uint32_t>(std::stoul(item.substr(dots + 2)));
+      if (first > last) {
+          throw std::invalid_argument("Empty range: " + item);
+      }
+      for (uint32_t v = first; v <= last; ++v) {
+          result.push_back(v);
+      }
+  }
+  return result;
 }
\ No newline at end of file
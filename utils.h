@@ -5,19 +5,11 @@
 #include <cstddef>
 #include <vector>
 #include <string>
+#include <map>
 
-std::vector<double> generateRandomDoubleVector(size_t size, uint32_t seed);
-template<typename Func>
-std::pair<double, double> measureOperation(Func&& func, int num_runs);
+#include "profiler.h"
 
-struct ProfileData {
-    double firstRunTime;
-    double avgTimeExcludingFirst;
-    std::string operationName;
-};
-
-template<typename F, typename... Args>
-ProfileData measureOperation(const std::string& opName, uint32_t numRuns, F&& func, Args&&... args);
+std::vector<double> generateRandomDoubleVector(size_t size, uint32_t seed);
 
 void printProfileResults(const std::vector<ProfileData>& profiles);
 
@@ -26,6 +18,66 @@ std::vector<double> pointwiseSubtract(const std::vector<double>& v1, const std::
 std::vector<double> pointwiseMultiply(const std::vector<double>& v1, const std::vector<double>& v2);
 std::vector<double> scalarMultiply(const std::vector<double>& v, double scalar);
 
+// Allocation-free variants writing into out, which must already have the inputs'
+// size and may be one of the inputs. They run the best SIMD kernels of the CPU.
+void pointwiseAdd(const std::vector<double>& v1, const std::vector<double>& v2, std::vector<double>& out);
+void pointwiseSubtract(const std::vector<double>& v1, const std::vector<double>& v2, std::vector<double>& out);
+void pointwiseMultiply(const std::vector<double>& v1, const std::vector<double>& v2, std::vector<double>& out);
+void scalarMultiply(const std::vector<double>& v, double scalar, std::vector<double>& out);
+
+// Command-line options of the form --key=value, --key value or --flag.
+// Options may also be read from a config file with one "key = value" per line;
+// values given on the command line take precedence over the file.
+struct BenchArgs {
+    std::map<std::string, std::string> values;
+
+    bool has(const std::string& key) const;
+    std::string get(const std::string& key, const std::string& defaultValue) const;
+    uint32_t getUInt(const std::string& key, uint32_t defaultValue) const;
+    std::vector<uint32_t> getUIntList(const std::string& key, const std::vector<uint32_t>& defaultValue) const;
+    std::vector<std::string> getList(const std::string& key, const std::vector<std::string>& defaultValue) const;
+};
+
+BenchArgs parseArgs(int argc, char* argv[]);
+
+// Reads --warmup, --min-runs, --runs (maximum runs), --rel-error, --max-time-ms
+// and --perf (hardware counters) on top of the benchmark's defaults.
+ProfileOptions profileOptionsFromArgs(const BenchArgs& args, const ProfileOptions& defaults);
+void loadConfigFile(BenchArgs& args, const std::string& path);
+
+// Splits one line of a CSV file, honouring double-quoted fields with "" escapes.
+std::vector<std::string> splitCSVLine(const std::string& line);
+
+// Parses "a,b,c" and inclusive ranges "a..b" (which may be mixed, e.g. "12..14,16").
+std::vector<uint32_t> parseUIntList(const std::string& text);
+
+// 1, 2, 4, ... up to maxThreads, always ending with maxThreads itself.
+std::vector<uint32_t> defaultThreadCounts(uint32_t maxThreads);
+
+// Intra-op parallelism of OpenMP-enabled OpenFHE builds. Without OpenMP these
+// report a single thread and setting the thread count is a no-op.
+void printThreadingInfo();
+uint32_t maxIntraOpThreads();
+uint32_t currentIntraOpThreads();
+void setIntraOpThreads(uint32_t numThreads);
+// Pins OpenMP worker i to core i unless OMP_PROC_BIND already controls placement.
+void pinIntraOpThreads(uint32_t numThreads);
+// CPU affinity of OpenMP workers 0..numThreads-1, saved before pinning and handed
+// back to restoreIntraOpAffinity afterwards. Empty where pinning is not supported.
+using IntraOpAffinity = std::vector<std::vector<unsigned char>>;
+IntraOpAffinity saveIntraOpAffinity(uint32_t numThreads);
+void restoreIntraOpAffinity(const IntraOpAffinity& affinity);
+
+struct ScalingRow {
+    std::string operationName;
+    uint32_t threads;
+    double latencyMs;
+    double speedup;
+    double efficiency;
+};
+
+void printScalingResults(const std::vector<ScalingRow>& rows);
+
 void printDoubleVector(const std::vector<double>& vec, const std::string& label, size_t numElements = 0);
 
 #endif  // UTILS_H
\ No newline at end of file